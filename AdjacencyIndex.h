@@ -0,0 +1,266 @@
+// -------------------------------
+// projects/graph/AdjacencyIndex.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef AdjacencyIndex_h
+#define AdjacencyIndex_h
+
+// --------
+// includes
+// --------
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <limits> // numeric_limits
+#include <vector> // vector
+
+
+// ---------------
+// adjacency_index
+// ---------------
+
+///
+/// A membership index over the adjacent vertices of one high-degree vertex
+/// A hub's index is an open-addressing hash set with linear probing, so a lookup is O(1) expected
+/// A dense row, whose degree is a large fraction of the number of vertices, uses a bitset instead, so a lookup is one bit probe
+/// Low-degree vertices do not get an index: a lookup in their adjacency container is already only a few comparisons
+/// @tparam V - the vertex descriptor type
+///
+template <typename V>
+class adjacency_index
+{
+public:
+	// ---------
+	// constants
+	// ---------
+
+	static const std::size_t hub_degree = 32; // the degree above which a vertex gets an index
+	static const std::size_t dense_ratio = 128; // a row is dense once degree * dense_ratio >= number of vertices
+
+private:
+	// ----
+	// data
+	// ----
+	std::vector<std::uint64_t> words; // hash slots holding vertex + 1, with 0 for an empty slot, or bitset words
+	std::size_t count; // number of vertices in the index
+	bool dense;
+
+	// ----
+	// slot
+	// ----
+
+	///
+	/// @param v - a vertex descriptor
+	/// @return the home slot of v in the hash table
+	///
+	std::size_t slot (V v) const
+	{
+		return static_cast<std::size_t>((static_cast<std::uint64_t>(v) * 0x9e3779b97f4a7c15ull) >> 32) & (words.size() - 1);
+	}
+
+	// ------
+	// rehash
+	// ------
+
+	///
+	/// Move the hash set to a table of the given capacity
+	/// @param capacity - the new number of slots, a power of two
+	///
+	void rehash (std::size_t capacity)
+	{
+		std::vector<std::uint64_t> old(capacity, 0);
+		old.swap(words);
+		for(std::uint64_t w : old)
+		{
+			if(w != 0)
+				place(static_cast<V>(w - 1));
+		}
+	}
+
+	// -----
+	// place
+	// -----
+
+	///
+	/// Put a vertex, which is not in the hash set, into its first free slot
+	/// @param v - a vertex descriptor
+	///
+	void place (V v)
+	{
+		std::size_t i = slot(v);
+		while(words[i] != 0)
+			i = (i + 1) & (words.size() - 1);
+		words[i] = static_cast<std::uint64_t>(v) + 1;
+	}
+
+	// ----------
+	// make_dense
+	// ----------
+
+	///
+	/// Convert the hash set into a bitset
+	/// @param n - the number of vertices of the graph
+	///
+	void make_dense (std::size_t n)
+	{
+		std::vector<std::uint64_t> old(n / 64 + 1, 0);
+		old.swap(words);
+		dense = true;
+		for(std::uint64_t w : old)
+		{
+			if(w != 0)
+				set(static_cast<V>(w - 1));
+		}
+	}
+
+	// ---
+	// set
+	// ---
+
+	///
+	/// Set the bit of a vertex in the bitset, growing the bitset if needed
+	/// @param v - a vertex descriptor
+	///
+	void set (V v)
+	{
+		std::size_t i = static_cast<std::size_t>(v) / 64;
+		if(i >= words.size())
+			words.resize(i + i / 2 + 1, 0);
+		words[i] |= std::uint64_t(1) << (v % 64);
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Build an index over a range of distinct vertices
+	/// @tparam II - Input Iterator Template
+	/// @param b - the beginning of the adjacent vertices
+	/// @param e - the end of the adjacent vertices
+	/// @param size - the number of adjacent vertices
+	/// @param n - the number of vertices of the graph
+	///
+	template <typename II>
+	adjacency_index (II b, II e, std::size_t size, std::size_t n) : count(0), dense(false)
+	{
+		std::size_t capacity = 1;
+		while(capacity < 2 * size)
+			capacity *= 2;
+		words.assign(capacity, 0);
+		for(; b != e; ++b)
+			insert(*b, n);
+	}
+
+	// Default copy, destructor, and copy assignment
+
+	// --------
+	// contains
+	// --------
+
+	///
+	/// @param v - a vertex descriptor
+	/// @return true if v is in the index
+	///
+	bool contains (V v) const
+	{
+		if(dense)
+		{
+			std::size_t i = static_cast<std::size_t>(v) / 64;
+			return i < words.size() && ((words[i] >> (v % 64)) & 1) != 0;
+		}
+
+		const std::uint64_t w = static_cast<std::uint64_t>(v) + 1;
+		for(std::size_t i = slot(v); words[i] != 0; i = (i + 1) & (words.size() - 1))
+		{
+			if(words[i] == w)
+				return true;
+		}
+		return false;
+	}
+
+	// ------
+	// insert
+	// ------
+
+	///
+	/// Add a vertex, which is not in the index yet
+	/// The hash set keeps a load factor of at most 1/2, and becomes a bitset once the row is dense
+	/// @param v - a vertex descriptor
+	/// @param n - the number of vertices of the graph
+	///
+	void insert (V v, std::size_t n)
+	{
+		assert(!contains(v));
+		++count;
+		if(!dense && count * dense_ratio >= n)
+			make_dense(n);
+		if(dense)
+		{
+			set(v);
+			return;
+		}
+		if(2 * count > words.size())
+			rehash(2 * words.size());
+		place(v);
+	}
+
+	// -----
+	// erase
+	// -----
+
+	///
+	/// Remove a vertex, which is in the index
+	/// A hash set closes the hole with backward-shift deletion, so lookups never need tombstones
+	/// @param v - a vertex descriptor
+	///
+	void erase (V v)
+	{
+		assert(contains(v));
+		--count;
+		if(dense)
+		{
+			words[static_cast<std::size_t>(v) / 64] &= ~(std::uint64_t(1) << (v % 64));
+			return;
+		}
+
+		const std::size_t mask = words.size() - 1;
+		std::size_t i = slot(v);
+		while(words[i] != static_cast<std::uint64_t>(v) + 1)
+			i = (i + 1) & mask;
+		// Move back every later entry of the probe run whose home slot is not between the hole and the entry
+		for(std::size_t j = (i + 1) & mask; words[j] != 0; j = (j + 1) & mask)
+		{
+			const std::size_t k = slot(static_cast<V>(words[j] - 1));
+			if(((j - k) & mask) >= ((j - i) & mask))
+			{
+				words[i] = words[j];
+				i = j;
+			}
+		}
+		words[i] = 0;
+	}
+
+	// ----
+	// size
+	// ----
+
+	///
+	/// @return the number of vertices in the index
+	///
+	std::size_t size () const
+	{
+		return count;
+	}
+};
+
+template <typename V>
+const std::size_t adjacency_index<V>::hub_degree;
+
+template <typename V>
+const std::size_t adjacency_index<V>::dense_ratio;
+
+#endif // AdjacencyIndex_h
@@ -0,0 +1,366 @@
+// -------------------------------
+// projects/graph/ArenaAllocator.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef ArenaAllocator_h
+#define ArenaAllocator_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // max, min
+#include <cstddef> // size_t
+#include <memory> // make_shared, shared_ptr
+#include <new> // operator delete, operator new
+#include <type_traits> // true_type
+#include <utility> // swap
+#include <vector> // vector
+
+#include "GraphTrace.h" // GRAPH_TRACE_COUNT
+
+
+// -----
+// Arena
+// -----
+
+const std::size_t arena_granularity = 16; // size classes are multiples of the granularity, which is also the block alignment
+const std::size_t arena_max_small = 256; // the largest block served from the chunks
+const std::size_t arena_first_chunk = 4096; // the size of the first chunk, small enough for a short-lived graph
+const std::size_t arena_max_chunk = 1 << 20; // the size that the chunks stop doubling at
+
+///
+/// A slab arena for the small, fixed-size blocks of node-based containers
+/// Blocks are bump-allocated from chunks that double in size up to arena_max_chunk, and freed blocks go to a free list per size class, so a container that erases and inserts reuses its own memory
+/// Blocks larger than arena_max_small go to the global operator new
+/// Every chunk is released at once when the arena is destroyed, and not before: freed blocks are reused, but the arena never shrinks
+/// An arena is not thread-safe: it, and every arena_allocator that shares it, belongs to one thread at a time
+///
+class Arena
+{
+private:
+	// ----------
+	// free_block
+	// ----------
+
+	struct free_block
+	{
+		free_block* next;
+	};
+
+	// ----
+	// data
+	// ----
+	char* current; // the next free byte of the current chunk
+	std::size_t remaining; // the number of free bytes left in the current chunk
+	std::size_t next_chunk; // the size of the next chunk
+	std::size_t reserved; // the total size of the chunks
+	std::vector<void*> chunks;
+	free_block* free_lists[arena_max_small / arena_granularity];
+
+	template <typename T>
+	friend class arena_allocator;
+
+	// ----------
+	// size_class
+	// ----------
+
+	///
+	/// @param bytes - the size of a small block
+	/// @return the index of the free list of the block, whose size class is (index + 1) * arena_granularity bytes
+	///
+	static std::size_t size_class (std::size_t bytes)
+	{
+		return bytes == 0 ? 0 : (bytes - 1) / arena_granularity;
+	}
+
+	// ------
+	// refill
+	// ------
+
+	///
+	/// Start a new chunk that holds at least one block of the given size
+	/// The rest of the current chunk is abandoned, which wastes less than arena_max_small bytes
+	/// @param size - the size of the block that did not fit
+	///
+	void refill (std::size_t size)
+	{
+		std::size_t bytes = std::max(next_chunk, size);
+		current = static_cast<char*>(::operator new(bytes));
+		GRAPH_TRACE_COUNT(allocations, 1);
+		chunks.push_back(current);
+		remaining = bytes;
+		reserved += bytes;
+		next_chunk = std::min(2 * next_chunk, arena_max_chunk);
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - Empty Arena, which does not allocate a chunk until its first block
+	///
+	Arena () : current(nullptr), remaining(0), next_chunk(arena_first_chunk), reserved(0)
+	{
+		for(free_block*& head : free_lists)
+			head = nullptr;
+	}
+
+	Arena (const Arena&) = delete;
+	Arena& operator = (const Arena&) = delete;
+
+	// ----------
+	// destructor
+	// ----------
+
+	///
+	/// Release every chunk at once
+	///
+	~Arena ()
+	{
+		for(void* chunk : chunks)
+			::operator delete(chunk);
+	}
+
+	// --------
+	// allocate
+	// --------
+
+	///
+	/// @param bytes - the size of the block
+	/// @return a block of at least the given size, aligned to the granularity
+	///
+	void* allocate (std::size_t bytes)
+	{
+		if(bytes > arena_max_small)
+		{
+			GRAPH_TRACE_COUNT(allocations, 1);
+			return ::operator new(bytes);
+		}
+
+		const std::size_t c = size_class(bytes);
+		if(free_lists[c] != nullptr)
+		{
+			free_block* block = free_lists[c];
+			free_lists[c] = block->next;
+			return block;
+		}
+
+		const std::size_t size = (c + 1) * arena_granularity;
+		if(remaining < size)
+			refill(size);
+		void* block = current;
+		current += size;
+		remaining -= size;
+		return block;
+	}
+
+	// ----------
+	// deallocate
+	// ----------
+
+	///
+	/// Return a block to its free list, or to the global operator delete if it is large
+	/// @param p - a block returned by allocate
+	/// @param bytes - the size that the block was allocated with
+	///
+	void deallocate (void* p, std::size_t bytes)
+	{
+		if(bytes > arena_max_small)
+		{
+			::operator delete(p);
+			return;
+		}
+
+		const std::size_t c = size_class(bytes);
+		free_block* block = static_cast<free_block*>(p);
+		block->next = free_lists[c];
+		free_lists[c] = block;
+	}
+
+	// --------
+	// capacity
+	// --------
+
+	///
+	/// @return the total size of the chunks, in bytes
+	///
+	std::size_t capacity () const
+	{
+		return reserved;
+	}
+};
+
+// ---------------
+// arena_allocator
+// ---------------
+
+///
+/// A standard allocator that serves a container's blocks from a reference-counted Arena
+/// Copies of an allocator, and the rebound allocators that a container makes for its nodes, share the arena, which is destroyed with its last allocator
+/// A copied container gets a new arena, so it neither shares nor keeps alive the original's memory
+/// @tparam T - the value type
+///
+template <typename T>
+class arena_allocator
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef arena_allocator<U> other;
+	};
+
+	static_assert(alignof(T) <= arena_granularity, "arena_allocator: the value type is over-aligned");
+
+private:
+	// ----
+	// data
+	// ----
+	std::shared_ptr<Arena> heap; // The arena and its count of allocators, which deletes it with the last one
+
+	template <typename U>
+	friend class arena_allocator;
+
+public:
+	// -----------
+	// operator ==
+	// -----------
+
+	/**
+	* equal operator
+	* @param lhs - the left hand side allocator
+	* @param rhs - the right hand side allocator
+	* @return true if the allocators share an arena, so each can free the other's blocks
+	*/
+	template <typename U>
+	friend bool operator == (const arena_allocator& lhs, const arena_allocator<U>& rhs)
+	{
+		return &lhs.arena() == &rhs.arena();
+	}
+
+	/**
+	* not equal operator
+	* @param lhs - the left hand side allocator
+	* @param rhs - the right hand side allocator
+	* @return true if the allocators have different arenas
+	*/
+	template <typename U>
+	friend bool operator != (const arena_allocator& lhs, const arena_allocator<U>& rhs)
+	{
+		return &lhs.arena() != &rhs.arena();
+	}
+
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - an allocator with a new, empty arena
+	///
+	arena_allocator () : heap(std::make_shared<Arena>())
+	{}
+
+	///
+	/// Copy Constructor - an allocator that shares the arena of another allocator
+	/// @param that - an allocator
+	///
+	arena_allocator (const arena_allocator& that) : heap(that.heap)
+	{}
+
+	///
+	/// Rebinding Constructor - an allocator that shares the arena of an allocator of another value type
+	/// @tparam U - the value type of the other allocator
+	/// @param that - an allocator
+	///
+	template <typename U>
+	arena_allocator (const arena_allocator<U>& that) : heap(that.heap)
+	{}
+
+	// Default destructor, which releases the arena, destroyed with its last allocator
+
+	// ----------
+	// operator =
+	// ----------
+
+	///
+	/// @param that - an allocator
+	/// @return this allocator, which now shares the arena of that
+	///
+	arena_allocator& operator = (arena_allocator that)
+	{
+		std::swap(heap, that.heap);
+		return *this;
+	}
+
+	// --------
+	// allocate
+	// --------
+
+	///
+	/// @param n - the number of objects
+	/// @return uninitialized storage for n objects
+	///
+	pointer allocate (size_type n)
+	{
+		return static_cast<pointer>(heap->allocate(n * sizeof(T)));
+	}
+
+	// ----------
+	// deallocate
+	// ----------
+
+	///
+	/// @param p - storage returned by allocate
+	/// @param n - the number of objects that the storage was allocated for
+	///
+	void deallocate (pointer p, size_type n)
+	{
+		heap->deallocate(p, n * sizeof(T));
+	}
+
+	// -------------------------------------
+	// select_on_container_copy_construction
+	// -------------------------------------
+
+	///
+	/// @return the allocator of a copied container, which has a new arena
+	///
+	arena_allocator select_on_container_copy_construction () const
+	{
+		return arena_allocator();
+	}
+
+	// -----
+	// arena
+	// -----
+
+	///
+	/// @return the arena that the allocator allocates from
+	///
+	const Arena& arena () const
+	{
+		return *heap;
+	}
+};
+
+#endif // ArenaAllocator_h
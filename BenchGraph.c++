@@ -0,0 +1,625 @@
+// -----------------------------
+// projects/graph/BenchGraph.c++
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+/*
+To run the benchmarks:
+    % g++ -O3 -DNDEBUG -pedantic -std=c++0x -Wall BenchGraph.c++ -o BenchGraph -lbenchmark -lpthread
+    % ./BenchGraph --benchmark_out=BenchGraph.json --benchmark_out_format=json
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // shuffle
+#include <cmath> // pow
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <iterator> // back_inserter
+#include <memory> // allocator
+#include <mutex> // lock_guard, mutex
+#include <random> // mt19937_64, uniform_int_distribution, uniform_real_distribution
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "boost/graph/adjacency_list.hpp"  // adjacency_list
+
+#include "benchmark/benchmark.h"
+
+#include "Graph.h"
+#include "BreadthFirstSearch.h"
+#include "CSRGraph.h"
+#include "ConcurrentGraph.h"
+#include "CriticalPath.h"
+#include "EdgeProperty.h"
+#include "ReachabilityIndex.h"
+#include "Reorder.h"
+#include "ShortestPaths.h"
+#include "StrongComponents.h"
+#include "TopologicalOrder.h"
+#include "TriangleCount.h"
+
+typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> BoostGraph;
+typedef basic_graph<std::size_t, ordered_setS, std::allocator<std::size_t> > HeapGraph; // Graph without the arena, for comparison
+typedef basic_graph<std::uint32_t, sorted_vecS> CompactGraph;
+typedef std::vector<std::pair<std::size_t, std::size_t> > edge_list;
+
+// ------
+// shapes
+// ------
+
+///
+/// The synthetic graphs of the benchmarks
+/// random: uniformly random edges, usually cyclic
+/// chain: a single path 0 -> 1 -> ... -> n - 1
+/// dag: uniformly random edges from a lower to a higher vertex
+/// powerlaw: edges from a lower to a higher vertex, with targets skewed toward a few hub vertices
+///
+enum shape
+{
+	shape_random,
+	shape_chain,
+	shape_dag,
+	shape_powerlaw
+};
+
+const std::size_t average_degree = 8;
+
+///
+/// Generate the edge list of a synthetic graph, the same one for every run
+/// @param s - the shape of the graph
+/// @param n - the number of vertices
+/// @return the edges of the graph, in random order
+///
+edge_list make_edges (shape s, std::size_t n)
+{
+	std::mt19937_64 random(n * 4 + s);
+	std::uniform_int_distribution<std::size_t> any(0, n - 1);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	edge_list ed;
+
+	if(s == shape_chain)
+	{
+		for(std::size_t v = 0; v + 1 < n; ++v)
+			ed.push_back(std::make_pair(v, v + 1));
+		return ed;
+	}
+
+	while(ed.size() < average_degree * n)
+	{
+		std::size_t u = any(random);
+		std::size_t v = (s == shape_powerlaw) ? static_cast<std::size_t>(n * std::pow(unit(random), 3.0)) : any(random);
+		if(s != shape_random)
+		{
+			if(u == v)
+				continue;
+			if(u > v)
+				std::swap(u, v);
+		}
+		ed.push_back(std::make_pair(u, v));
+	}
+	return ed;
+}
+
+///
+/// Build a graph one add_edge call at a time
+/// @tparam G - Graph Class Template
+/// @param ed - the edge list
+/// @param n - the number of vertices
+/// @param graph - an empty graph
+///
+template <typename G>
+void fill (const edge_list& ed, std::size_t n, G& graph)
+{
+	for(std::size_t v = 0; v < n; ++v)
+		add_vertex(graph);
+	for(const std::pair<std::size_t, std::size_t>& e : ed)
+		add_edge(e.first, e.second, graph);
+}
+
+///
+/// Build a CSRGraph with its range constructor
+/// @param ed - the edge list
+/// @param n - the number of vertices
+/// @param graph - an empty graph
+///
+void fill (const edge_list& ed, std::size_t n, CSRGraph& graph)
+{
+	graph = CSRGraph(ed.begin(), ed.end(), n);
+}
+
+// ----------
+// benchmarks
+// ----------
+
+template <typename G, shape S>
+void BM_add_edge (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	for(auto _ : state)
+	{
+		G graph;
+		fill(ed, n, graph);
+		benchmark::DoNotOptimize(num_edges(graph));
+	}
+	state.SetItemsProcessed(state.iterations() * ed.size());
+}
+
+template <typename G, shape S>
+void BM_locked_add_edge (benchmark::State& state)
+{
+	// Every thread of the pool adds its share of the edges behind one mutex, as ingest did before ConcurrentGraph
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	ThreadPool pool;
+	for(auto _ : state)
+	{
+		G graph;
+		std::mutex guard;
+		pool.parallel_for(0, ed.size(), [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t i = b; i < e; ++i)
+			{
+				std::lock_guard<std::mutex> locked(guard);
+				add_edge(ed[i].first, ed[i].second, graph);
+			}
+		});
+		benchmark::DoNotOptimize(num_edges(graph));
+	}
+	state.SetItemsProcessed(state.iterations() * ed.size());
+}
+
+template <typename V, shape S>
+void BM_concurrent_add_edge (benchmark::State& state)
+{
+	// Every thread of the pool adds its share of the edges to a ConcurrentGraph, which is then frozen
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	ThreadPool pool;
+	for(auto _ : state)
+	{
+		ConcurrentGraph<V> graph;
+		pool.parallel_for(0, ed.size(), [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t i = b; i < e; ++i)
+				add_edge(static_cast<V>(ed[i].first), static_cast<V>(ed[i].second), graph);
+		});
+		CSRGraph frozen = freeze(graph, pool);
+		benchmark::DoNotOptimize(num_edges(frozen));
+	}
+	state.SetItemsProcessed(state.iterations() * ed.size());
+}
+
+template <typename G, shape S>
+void BM_edge (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::mt19937_64 random(n);
+	std::uniform_int_distribution<std::size_t> any(0, n - 1);
+	for(auto _ : state)
+	{
+		// Half of the queries hit an existing edge
+		const std::pair<std::size_t, std::size_t>& e = ed[any(random) % ed.size()];
+		benchmark::DoNotOptimize(edge(e.first, e.second, graph).second);
+		benchmark::DoNotOptimize(edge(e.first, any(random), graph).second);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template <typename G, shape S>
+void BM_edges (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	for(auto _ : state)
+	{
+		std::size_t sum = 0;
+		std::pair<typename G::edge_iterator, typename G::edge_iterator> p = edges(graph);
+		for(; p.first != p.second; ++p.first)
+			sum += target(*p.first, graph);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * num_edges(graph));
+}
+
+template <typename G, shape S>
+void BM_adjacent_vertices (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	for(auto _ : state)
+	{
+		std::size_t sum = 0;
+		std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
+		for(; v.first != v.second; ++v.first)
+		{
+			std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(*v.first, graph);
+			for(; av.first != av.second; ++av.first)
+				sum += *av.first;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * num_edges(graph));
+}
+
+template <typename G, shape S>
+void BM_has_cycle (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::has_cycle(graph));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_topological_sort (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<typename G::vertex_descriptor> order;
+	order.reserve(num_vertices(graph));
+	for(auto _ : state)
+	{
+		order.clear();
+		::topological_sort(graph, std::back_inserter(order));
+		benchmark::DoNotOptimize(order.data());
+	}
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_topological_order (benchmark::State& state)
+{
+	// Insert the edges of a DAG in random order, keeping a topological order after every insertion
+	// The edges go from higher to lower vertices, against the initial order of the vertices, so insertions reorder
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	for(auto _ : state)
+	{
+		TopologicalOrder<G> order;
+		for(const std::pair<std::size_t, std::size_t>& e : ed)
+			add_edge(n - 1 - e.first, n - 1 - e.second, order);
+		benchmark::DoNotOptimize(order.order().data());
+	}
+	state.SetItemsProcessed(state.iterations() * ed.size());
+}
+
+template <typename G, shape S>
+void BM_strongly_connected_components (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<std::size_t> component(num_vertices(graph));
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::strongly_connected_components(graph, component.begin()));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_parallel_strongly_connected_components (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<std::size_t> component(num_vertices(graph));
+	ThreadPool pool;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::parallel_strongly_connected_components(graph, component.begin(), pool));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_breadth_first_search (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<std::size_t> distance(num_vertices(graph));
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::breadth_first_search(graph, vertex(0, graph), distance.begin()));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_parallel_breadth_first_search (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<std::size_t> distance(num_vertices(graph));
+	std::vector<typename G::vertex_descriptor> sources(1, vertex(0, graph));
+	ThreadPool pool;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::parallel_breadth_first_search(graph, sources.begin(), sources.end(), distance.begin(), pool));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_direction_optimizing_breadth_first_search (benchmark::State& state)
+{
+	// The transposed edges are built once, outside the timed loop, as for many searches of one graph
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<std::size_t> distance(num_vertices(graph));
+	std::vector<typename G::vertex_descriptor> sources(1, vertex(0, graph));
+	ThreadPool pool;
+	std::vector<std::size_t> in_offsets;
+	std::vector<typename G::vertex_descriptor> in_sources;
+	transpose_adjacency(graph, in_offsets, in_sources, pool);
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::parallel_breadth_first_search(graph, sources.begin(), sources.end(), distance.begin(), in_offsets, in_sources, pool));
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_triangle_count (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::triangle_count(graph));
+	state.SetItemsProcessed(state.iterations() * num_edges(graph));
+}
+
+template <typename G, shape S>
+void BM_parallel_triangle_count (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	ThreadPool pool;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::triangle_count(graph, pool));
+	state.SetItemsProcessed(state.iterations() * num_edges(graph));
+}
+
+template <typename G, shape S, typename W = unsigned>
+void BM_dijkstra_shortest_paths (benchmark::State& state)
+{
+	// unsigned weights take the radix_heap, and double weights the 4-ary dary_heap
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	edge_property_map<W> weight(graph, [] (std::size_t u, std::size_t v) -> W
+	{
+		return W((u * 31 + v * 17) % 1000 + 1);
+	});
+	std::vector<W> distance(n);
+	for(auto _ : state)
+	{
+		::dijkstra_shortest_paths(graph, weight, vertex(0, graph), distance.begin());
+		benchmark::DoNotOptimize(distance.data());
+	}
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_reachability_index (benchmark::State& state)
+{
+	// range(1) is the largest bitset table in bytes, 0 to build intervals
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	for(auto _ : state)
+	{
+		reachability_index<typename G::vertex_descriptor> index(graph, state.range(1));
+		benchmark::DoNotOptimize(index.size());
+	}
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_parallel_reachability_index (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	ThreadPool pool;
+	for(auto _ : state)
+	{
+		reachability_index<typename G::vertex_descriptor> index(graph, pool, state.range(1));
+		benchmark::DoNotOptimize(index.size());
+	}
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_reaches (benchmark::State& state)
+{
+	// Random queries against the index, with range(1) as in BM_reachability_index
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	reachability_index<typename G::vertex_descriptor> index(graph, state.range(1));
+	std::mt19937_64 random(n);
+	std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+	std::vector<std::pair<std::size_t, std::size_t> > queries(1024);
+	for(std::pair<std::size_t, std::size_t>& q : queries)
+		q = std::make_pair(pick(random), pick(random));
+	for(auto _ : state)
+	{
+		std::size_t found = 0;
+		for(const std::pair<std::size_t, std::size_t>& q : queries)
+			found += index.reaches(q.first, q.second);
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+template <typename G, shape S>
+void BM_critical_path (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<double> cost(n);
+	for(std::size_t v = 0; v != n; ++v)
+		cost[v] = double(v % 7 + 1);
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::critical_path(graph, cost.begin()).length);
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+template <typename G, shape S>
+void BM_parallel_critical_path (benchmark::State& state)
+{
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(S, n);
+	G graph;
+	fill(ed, n, graph);
+	std::vector<double> cost(n);
+	for(std::size_t v = 0; v != n; ++v)
+		cost[v] = double(v % 7 + 1);
+	ThreadPool pool;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(::critical_path(graph, cost.begin(), pool).length);
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+///
+/// The labels of a reordered benchmark graph: scrambled, which scatters the vertices of the generated graph at random, or a strategy of reorder applied to the scrambled graph
+///
+const int scrambled = -1;
+
+template <typename G, int R>
+void BM_reordered_traversal (benchmark::State& state)
+{
+	// A breadth-first search and a cycle check over a power-law graph whose hubs are scattered, then relabeled for locality
+	const std::size_t n = state.range(0);
+	edge_list ed = make_edges(shape_powerlaw, n);
+	std::vector<std::size_t> scatter(n);
+	for(std::size_t v = 0; v != n; ++v)
+		scatter[v] = v;
+	std::shuffle(scatter.begin(), scatter.end(), std::mt19937_64(n));
+	for(std::pair<std::size_t, std::size_t>& e : ed)
+		e = std::make_pair(scatter[e.first], scatter[e.second]);
+	G graph(ed.begin(), ed.end(), n);
+	if(R != scrambled)
+		graph = relabel(graph, reorder(graph, static_cast<reorder_strategy>(R)));
+	std::vector<std::size_t> distance(n);
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(::breadth_first_search(graph, vertex(0, graph), distance.begin()));
+		benchmark::DoNotOptimize(::has_cycle(graph));
+	}
+	state.SetItemsProcessed(state.iterations() * (num_vertices(graph) + num_edges(graph)));
+}
+
+// ------------
+// registration
+// ------------
+
+#define GRAPH_BENCHMARK(bm, G, S) \
+	BENCHMARK_TEMPLATE(bm, G, S)->RangeMultiplier(8)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMicrosecond)
+
+#define GRAPH_BENCHMARK_TYPES(bm, S) \
+	GRAPH_BENCHMARK(bm, Graph, S); \
+	GRAPH_BENCHMARK(bm, CompactGraph, S); \
+	GRAPH_BENCHMARK(bm, CSRGraph, S); \
+	GRAPH_BENCHMARK(bm, BoostGraph, S)
+
+#define GRAPH_BENCHMARK_SHAPES(bm) \
+	GRAPH_BENCHMARK_TYPES(bm, shape_random); \
+	GRAPH_BENCHMARK_TYPES(bm, shape_chain); \
+	GRAPH_BENCHMARK_TYPES(bm, shape_dag); \
+	GRAPH_BENCHMARK_TYPES(bm, shape_powerlaw)
+
+GRAPH_BENCHMARK_SHAPES(BM_add_edge);
+GRAPH_BENCHMARK(BM_add_edge, HeapGraph, shape_random);
+GRAPH_BENCHMARK(BM_add_edge, HeapGraph, shape_powerlaw);
+GRAPH_BENCHMARK(BM_locked_add_edge, Graph, shape_random);
+GRAPH_BENCHMARK(BM_locked_add_edge, Graph, shape_powerlaw);
+GRAPH_BENCHMARK(BM_concurrent_add_edge, std::size_t, shape_random);
+GRAPH_BENCHMARK(BM_concurrent_add_edge, std::size_t, shape_powerlaw);
+GRAPH_BENCHMARK(BM_concurrent_add_edge, std::uint32_t, shape_random);
+GRAPH_BENCHMARK_SHAPES(BM_edge);
+GRAPH_BENCHMARK_SHAPES(BM_edges);
+GRAPH_BENCHMARK_SHAPES(BM_adjacent_vertices);
+GRAPH_BENCHMARK_SHAPES(BM_has_cycle);
+
+// topological_sort needs an acyclic graph
+GRAPH_BENCHMARK_TYPES(BM_topological_sort, shape_chain);
+GRAPH_BENCHMARK_TYPES(BM_topological_sort, shape_dag);
+GRAPH_BENCHMARK_TYPES(BM_topological_sort, shape_powerlaw);
+
+GRAPH_BENCHMARK(BM_topological_order, Graph, shape_dag);
+GRAPH_BENCHMARK(BM_topological_order, CompactGraph, shape_dag);
+GRAPH_BENCHMARK(BM_topological_order, Graph, shape_powerlaw);
+
+GRAPH_BENCHMARK(BM_strongly_connected_components, Graph, shape_random);
+GRAPH_BENCHMARK(BM_strongly_connected_components, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_strongly_connected_components, CSRGraph, shape_chain);
+GRAPH_BENCHMARK(BM_parallel_strongly_connected_components, Graph, shape_random);
+GRAPH_BENCHMARK(BM_parallel_strongly_connected_components, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_parallel_strongly_connected_components, CSRGraph, shape_chain);
+GRAPH_BENCHMARK(BM_breadth_first_search, Graph, shape_random);
+GRAPH_BENCHMARK(BM_breadth_first_search, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_breadth_first_search, CSRGraph, shape_powerlaw);
+GRAPH_BENCHMARK(BM_parallel_breadth_first_search, Graph, shape_random);
+GRAPH_BENCHMARK(BM_parallel_breadth_first_search, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_parallel_breadth_first_search, CSRGraph, shape_powerlaw);
+GRAPH_BENCHMARK(BM_direction_optimizing_breadth_first_search, Graph, shape_random);
+GRAPH_BENCHMARK(BM_direction_optimizing_breadth_first_search, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_direction_optimizing_breadth_first_search, CSRGraph, shape_powerlaw);
+GRAPH_BENCHMARK_TYPES(BM_triangle_count, shape_random);
+GRAPH_BENCHMARK_TYPES(BM_triangle_count, shape_powerlaw);
+GRAPH_BENCHMARK(BM_parallel_triangle_count, CSRGraph, shape_powerlaw);
+GRAPH_BENCHMARK(BM_dijkstra_shortest_paths, Graph, shape_random);
+GRAPH_BENCHMARK(BM_dijkstra_shortest_paths, CSRGraph, shape_random);
+GRAPH_BENCHMARK(BM_dijkstra_shortest_paths, CSRGraph, shape_powerlaw);
+BENCHMARK_TEMPLATE(BM_dijkstra_shortest_paths, CSRGraph, shape_random, double)->RangeMultiplier(8)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_dijkstra_shortest_paths, CSRGraph, shape_powerlaw, double)->RangeMultiplier(8)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMicrosecond);
+GRAPH_BENCHMARK(BM_critical_path, Graph, shape_dag);
+GRAPH_BENCHMARK(BM_critical_path, CSRGraph, shape_dag);
+GRAPH_BENCHMARK(BM_critical_path, CSRGraph, shape_chain);
+GRAPH_BENCHMARK(BM_parallel_critical_path, CSRGraph, shape_dag);
+GRAPH_BENCHMARK(BM_parallel_critical_path, CSRGraph, shape_chain);
+#define REACHABILITY_BENCHMARK(bm, G, S) \
+	BENCHMARK_TEMPLATE(bm, G, S)->ArgsProduct({{1 << 10, 1 << 13, 1 << 16}, {1 << 28, 0}})->Unit(benchmark::kMicrosecond)
+
+REACHABILITY_BENCHMARK(BM_reachability_index, CSRGraph, shape_dag);
+REACHABILITY_BENCHMARK(BM_parallel_reachability_index, CSRGraph, shape_dag);
+REACHABILITY_BENCHMARK(BM_reaches, CSRGraph, shape_dag);
+#define REORDER_BENCHMARK(G, R) \
+	BENCHMARK_TEMPLATE(BM_reordered_traversal, G, R)->RangeMultiplier(16)->Range(1 << 16, 1 << 20)->Unit(benchmark::kMillisecond)
+
+REORDER_BENCHMARK(CSRGraph, scrambled);
+REORDER_BENCHMARK(CSRGraph, reverse_cuthill_mckee);
+REORDER_BENCHMARK(CSRGraph, degree_descending);
+REORDER_BENCHMARK(CSRGraph, breadth_first_order);
+REORDER_BENCHMARK(CSRGraph, depth_first_order);
+REORDER_BENCHMARK(CompactGraph, scrambled);
+REORDER_BENCHMARK(CompactGraph, breadth_first_order);
+
+BENCHMARK_MAIN();
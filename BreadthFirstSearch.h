@@ -0,0 +1,378 @@
+// -----------------------------------
+// projects/graph/BreadthFirstSearch.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef BreadthFirstSearch_h
+#define BreadthFirstSearch_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // fill, max, min
+#include <atomic> // atomic
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <iterator> // distance
+#include <limits> // numeric_limits
+#include <mutex> // lock_guard, mutex
+#include <utility> // pair
+#include <vector> // vector
+
+#include "Graph.h" // Graph, transpose_adjacency
+#include "ThreadPool.h" // ThreadPool
+
+
+// ---------
+// constants
+// ---------
+
+const std::size_t unreached = std::numeric_limits<std::size_t>::max(); // the distance of a vertex that no source reaches
+const std::size_t bfs_grain = 1024; // the smallest frontier that is expanded by more than one thread
+const std::size_t bfs_alpha = 14; // a top-down search turns bottom-up once the frontier has more than 1 / bfs_alpha of the unexplored edges
+const std::size_t bfs_beta = 24; // a bottom-up search turns top-down once the frontier has fewer than 1 / bfs_beta of the vertices
+
+// --------------------
+// breadth_first_search
+// --------------------
+
+///
+/// breadth-first traversal
+/// Find the distance of every vertex from the nearest of several sources, in edges
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param distance - receives the distance of each vertex, distance[v] for vertex v, or unreached
+/// @return the number of vertices reached, including the sources
+///
+template <typename G, typename II, typename RI>
+std::size_t breadth_first_search (const G& graph, II b, II e, RI distance)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	GRAPH_TRACE_PHASE("breadth_first_search");
+	std::fill(distance, distance + num_vertices(graph), unreached);
+	std::vector<vertex_descriptor> queue;
+	for(; b != e; ++b)
+	{
+		if(distance[*b] == unreached)
+		{
+			distance[*b] = 0;
+			queue.push_back(*b);
+		}
+	}
+	for(std::size_t i = 0; i != queue.size(); ++i)
+	{
+		const vertex_descriptor u = queue[i];
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		for(; av.first != av.second; ++av.first)
+		{
+			GRAPH_TRACE_COUNT(edges_scanned, 1);
+			if(distance[*av.first] == unreached)
+			{
+				distance[*av.first] = distance[u] + 1;
+				queue.push_back(*av.first);
+			}
+		}
+	}
+	GRAPH_TRACE_COUNT(vertices_visited, queue.size());
+	return queue.size();
+}
+
+///
+/// breadth-first traversal
+/// Find the distance of every vertex from the source, in edges
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param s - the source
+/// @param distance - receives the distance of each vertex, distance[v] for vertex v, or unreached
+/// @return the number of vertices reached, including the source
+///
+template <typename G, typename RI>
+std::size_t breadth_first_search (const G& graph, typename G::vertex_descriptor s, RI distance)
+{
+	return breadth_first_search(graph, &s, &s + 1, distance);
+}
+
+// -----------------------------
+// parallel_breadth_first_search
+// -----------------------------
+
+///
+/// breadth-first traversal, direction-optimizing
+/// Find the distance of every vertex from the nearest of several sources with every thread of the pool
+/// The search expands one level at a time, in one of two directions:
+/// top-down, each vertex of the frontier claims its unvisited adjacent vertices, with an atomic bit operation on the visited bitmap
+/// bottom-up, each unvisited vertex looks for an in-edge from the frontier bitmap and stops at the first one; each thread owns whole words of the bitmaps, so no atomics are needed
+/// Top-down costs the edges of the frontier, and bottom-up at most the edges of the unvisited vertices, so the search turns bottom-up while the frontier is large, as in the middle levels of a small-world graph
+/// The bottom-up levels read the transposed edges, as built by transpose_adjacency, which costs about three top-down searches; build them once for many searches of the same graph
+/// With empty transposed edges the search stays top-down
+/// The distances do not depend on the direction or the thread schedule
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param distance - receives the distance of each vertex, distance[v] for vertex v, or unreached
+/// @param in_offsets - the row offsets of the transposed edges, or empty
+/// @param in_sources - the sources of the in-edges, by row
+/// @param pool - the threads that run the search
+/// @return the number of vertices reached, including the sources
+///
+template <typename G, typename II, typename RI>
+std::size_t parallel_breadth_first_search (const G& graph, II b, II e, RI distance, const std::vector<std::size_t>& in_offsets, const std::vector<typename G::vertex_descriptor>& in_sources, ThreadPool& pool)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	GRAPH_TRACE_PHASE("parallel_breadth_first_search");
+	const std::size_t n = num_vertices(graph);
+	const std::size_t words = (n + 63) / 64;
+	// The edges of the frontier only decide when to turn bottom-up, so a search without the transposed edges does not count them
+	auto degree = [&] (vertex_descriptor v) -> std::size_t
+	{
+		if(in_offsets.empty())
+			return 0;
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+		return std::distance(av.first, av.second);
+	};
+
+	std::vector<std::atomic<std::uint64_t> > visited(words);
+	pool.parallel_for(0, words, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t w = b; w < e; ++w)
+			visited[w].store(0, std::memory_order_relaxed);
+		std::fill(distance + b * 64, distance + std::min(n, e * 64), unreached);
+	});
+
+	// The frontier is a list of vertices while the search is top-down, and a bitmap while it is bottom-up
+	std::vector<vertex_descriptor> frontier;
+	std::vector<std::uint64_t> current;
+	std::vector<std::uint64_t> next;
+	std::size_t frontier_edges = 0;
+	for(; b != e; ++b)
+	{
+		const std::uint64_t mask = std::uint64_t(1) << (*b % 64);
+		if((visited[*b / 64].fetch_or(mask, std::memory_order_relaxed) & mask) == 0)
+		{
+			distance[*b] = 0;
+			frontier.push_back(*b);
+			frontier_edges += degree(*b);
+		}
+	}
+
+	std::size_t unexplored = num_edges(graph);
+	std::size_t count = frontier.size();
+	std::size_t reached = count;
+	bool bottom_up = false;
+	std::mutex guard;
+	for(std::size_t level = 0; count != 0; ++level)
+	{
+		unexplored -= std::min(unexplored, frontier_edges);
+		if(!bottom_up && !in_offsets.empty() && frontier_edges > unexplored / bfs_alpha)
+		{
+			current.assign(words, 0);
+			next.assign(words, 0);
+			pool.parallel_for(0, words, [&] (std::size_t b, std::size_t e)
+			{
+				for(std::size_t v = b * 64; v < std::min(n, e * 64); ++v)
+				{
+					if(distance[v] == level)
+						current[v / 64] |= std::uint64_t(1) << (v % 64);
+				}
+			});
+			bottom_up = true;
+		}
+		else if(bottom_up && count < n / bfs_beta)
+		{
+			frontier.clear();
+			pool.parallel_for(0, words, [&] (std::size_t b, std::size_t e)
+			{
+				std::vector<vertex_descriptor> found;
+				for(std::size_t v = b * 64; v < std::min(n, e * 64); ++v)
+				{
+					if((current[v / 64] >> (v % 64)) & 1)
+						found.push_back(vertex(v, graph));
+				}
+				std::lock_guard<std::mutex> locked(guard);
+				frontier.insert(frontier.end(), found.begin(), found.end());
+			});
+			bottom_up = false;
+		}
+
+		count = 0;
+		frontier_edges = 0;
+		if(bottom_up)
+		{
+			pool.parallel_for(0, words, [&] (std::size_t b, std::size_t e)
+			{
+				std::size_t found = 0;
+				std::size_t edges = 0;
+				for(std::size_t w = b; w < e; ++w)
+				{
+					const std::uint64_t seen = visited[w].load(std::memory_order_relaxed);
+					std::uint64_t fresh = 0;
+					for(std::size_t v = w * 64; v < std::min(n, w * 64 + 64); ++v)
+					{
+						if((seen >> (v % 64)) & 1)
+							continue;
+						for(std::size_t j = in_offsets[v]; j != in_offsets[v + 1]; ++j)
+						{
+							const vertex_descriptor u = in_sources[j];
+							if((current[u / 64] >> (u % 64)) & 1)
+							{
+								fresh |= std::uint64_t(1) << (v % 64);
+								distance[v] = level + 1;
+								++found;
+								edges += degree(vertex(v, graph));
+								break;
+							}
+						}
+					}
+					next[w] = fresh;
+					if(fresh != 0)
+						visited[w].store(seen | fresh, std::memory_order_relaxed);
+				}
+				std::lock_guard<std::mutex> locked(guard);
+				count += found;
+				frontier_edges += edges;
+			});
+			current.swap(next);
+		}
+		else
+		{
+			std::vector<vertex_descriptor> expanded;
+			pool.parallel_for(0, frontier.size(), [&] (std::size_t b, std::size_t e)
+			{
+				std::vector<vertex_descriptor> found;
+				std::size_t edges = 0;
+				for(std::size_t i = b; i < e; ++i)
+				{
+					std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(frontier[i], graph);
+					for(; av.first != av.second; ++av.first)
+					{
+						const vertex_descriptor w = *av.first;
+						const std::uint64_t mask = std::uint64_t(1) << (w % 64);
+						if((visited[w / 64].load(std::memory_order_relaxed) & mask) == 0 && (visited[w / 64].fetch_or(mask, std::memory_order_relaxed) & mask) == 0)
+						{
+							distance[w] = level + 1;
+							found.push_back(w);
+							edges += degree(w);
+						}
+					}
+				}
+				std::lock_guard<std::mutex> locked(guard);
+				expanded.insert(expanded.end(), found.begin(), found.end());
+				frontier_edges += edges;
+			}, std::max(bfs_grain, frontier.size() / (4 * pool.size())));
+			frontier.swap(expanded);
+			count = frontier.size();
+		}
+		reached += count;
+	}
+	return reached;
+}
+
+///
+/// breadth-first traversal, top-down
+/// Find the distance of every vertex from the nearest of several sources with every thread of the pool, without the transposed edges
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param distance - receives the distance of each vertex, distance[v] for vertex v, or unreached
+/// @param pool - the threads that run the search
+/// @return the number of vertices reached, including the sources
+///
+template <typename G, typename II, typename RI>
+std::size_t parallel_breadth_first_search (const G& graph, II b, II e, RI distance, ThreadPool& pool)
+{
+	const std::vector<std::size_t> in_offsets;
+	const std::vector<typename G::vertex_descriptor> in_sources;
+	return parallel_breadth_first_search(graph, b, e, distance, in_offsets, in_sources, pool);
+}
+
+///
+/// Find the distance of every vertex from the nearest of several sources, with one thread per hardware thread
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param distance - receives the distance of each vertex, distance[v] for vertex v, or unreached
+/// @return the number of vertices reached, including the sources
+///
+template <typename G, typename II, typename RI>
+std::size_t parallel_breadth_first_search (const G& graph, II b, II e, RI distance)
+{
+	ThreadPool pool;
+	return parallel_breadth_first_search(graph, b, e, distance, pool);
+}
+
+// --------------
+// reachable_from
+// --------------
+
+///
+/// Find the vertices that have a path from at least one of the sources, which are the transitive dependencies of the sources when edges point at dependencies
+/// Every source reaches itself
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam OI - Output Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param x - an output iterator, which receives the reachable vertices in ascending order
+///
+template <typename G, typename II, typename OI>
+void reachable_from (const G& graph, II b, II e, OI x)
+{
+	std::vector<std::size_t> distance(num_vertices(graph));
+	breadth_first_search(graph, b, e, distance.begin());
+	for(std::size_t i = 0; i != distance.size(); ++i)
+	{
+		if(distance[i] != unreached)
+		{
+			*x = vertex(i, graph);
+			++x;
+		}
+	}
+}
+
+///
+/// Find the vertices that have a path from at least one of the sources with every thread of the pool, by parallel_breadth_first_search
+/// @tparam G - Graph Class Template
+/// @tparam II - Input Iterator Template, whose value_type is a vertex descriptor
+/// @tparam OI - Output Iterator Template
+/// @param graph - a graph
+/// @param b - the beginning of the sources
+/// @param e - the end of the sources
+/// @param x - an output iterator, which receives the reachable vertices in ascending order
+/// @param pool - the threads that run the search
+///
+template <typename G, typename II, typename OI>
+void reachable_from (const G& graph, II b, II e, OI x, ThreadPool& pool)
+{
+	std::vector<std::size_t> distance(num_vertices(graph));
+	parallel_breadth_first_search(graph, b, e, distance.begin(), pool);
+	for(std::size_t i = 0; i != distance.size(); ++i)
+	{
+		if(distance[i] != unreached)
+		{
+			*x = vertex(i, graph);
+			++x;
+		}
+	}
+}
+
+#endif // BreadthFirstSearch_h
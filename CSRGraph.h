@@ -0,0 +1,645 @@
+// -------------------------
+// projects/graph/CSRGraph.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -------------------------
+
+#ifndef CSRGraph_h
+#define CSRGraph_h
+
+// --------
+// includes
+// --------
+#include <boost/iterator/counting_iterator.hpp>
+#include <stddef.h> // ptrdiff_t
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <algorithm> // binary_search, lower_bound, max, sort, unique, upper_bound
+#include <iterator> // bidirectional_iterator_tag
+#include <utility> // make_pair, move, pair
+#include <vector> // vector
+
+#include "Graph.h" // has_cycle, sorted_edges, topological_sort
+
+
+// -----------------
+// csr_edge_iterator
+// -----------------
+
+///
+/// A bidirectional edge iterator over a graph in compressed sparse row (CSR) form
+/// The iterator holds the index of its edge in the targets array and the source vertex of that edge
+/// It only reads the offsets and targets arrays, so it serves both the CSRGraph and graphs mapped from a snapshot file
+/// @tparam V - the vertex descriptor type
+/// @tparam E - the edges size type, used for the row offsets
+///
+template <typename V, typename E>
+class csr_edge_iterator
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::bidirectional_iterator_tag		iterator_category;
+	typedef std::pair<V, V>		value_type;
+	typedef ptrdiff_t			difference_type;
+	typedef value_type*		pointer;
+	typedef value_type&		reference;
+
+public:
+	// -----------
+	// operator ==
+	// -----------
+
+	/**
+	* equal operator
+	* @param lhs - the left hand side Iterator
+	* @param rhs - the right hand side Iterator
+	* @return true if the lhs Iterator is equal to the rhs Iterator
+	*/
+	friend bool operator == (const csr_edge_iterator& lhs, const csr_edge_iterator& rhs)
+	{
+		return (lhs._offsets == rhs._offsets) && (lhs._index == rhs._index);
+	}
+
+	/**
+	* not equal operator
+	* @param lhs - the left hand side Iterator
+	* @param rhs - the right hand side Iterator
+	* @return true if the lhs Iterator is not equal to the rhs Iterator
+	*/
+	friend bool operator != (const csr_edge_iterator& lhs, const csr_edge_iterator& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// ----------
+	// operator +
+	// ----------
+
+	/**
+	* addition operator
+	* @param lhs - the left hand side Iterator
+	* @param rhs - the right hand side difference_type
+	* @return an Iterator shifted forward by the difference_type value
+	*/
+	friend csr_edge_iterator operator + (csr_edge_iterator lhs, difference_type rhs)
+	{
+		return lhs += rhs;
+	}
+
+	// ----------
+	// operator -
+	// ----------
+
+	/**
+	* subtraction operator
+	* @param lhs - the left hand side Iterator
+	* @param rhs - the right hand side difference_type
+	* @return an Iterator shifted backward by the difference_type value
+	*/
+	friend csr_edge_iterator operator - (csr_edge_iterator lhs, difference_type rhs)
+	{
+		return lhs -= rhs;
+	}
+
+private:
+	// ----
+	// data
+	// ----
+	const E* _offsets;
+	const V* _targets;
+	std::size_t _n; // number of vertices
+	E _index;
+	V _source;
+
+private:
+	// -----
+	// valid
+	// -----
+
+	/**
+	* @return true if the Iterator object is in a valid state
+	*/
+	bool valid () const
+	{
+		return (_offsets == nullptr && _index == 0) || (_offsets != nullptr && _index <= _offsets[_n] && _source <= _n);
+	}
+
+	// ----
+	// seek
+	// ----
+
+	/**
+	* Move the Iterator to the edge at position i in the targets array
+	* The source vertex is found with a binary search over the offsets
+	* @param i - the new index state for the Iterator
+	*/
+	void seek (E i)
+	{
+		_index = i;
+		if(_index >= _offsets[_n])
+			_source = _n;
+		else
+			_source = std::upper_bound(_offsets, _offsets + _n + 1, _index) - _offsets - 1;
+	}
+
+public:
+	// -----------
+	// constructor
+	// -----------
+
+	/**
+	* Create an Iterator object over the arrays of a graph in CSR form
+	* @param offsets - the n + 1 row offsets of the graph
+	* @param targets - the adjacent vertices of every row
+	* @param n - the number of vertices of the graph
+	* @param i - index state for the Iterator
+	*/
+	csr_edge_iterator (const E* offsets = nullptr, const V* targets = nullptr, std::size_t n = 0, E i = 0) : _offsets(offsets), _targets(targets), _n(n), _index(i), _source(0)
+	{
+		if(_offsets != nullptr)
+			seek(_index);
+		assert(valid());
+	}
+
+	// Default copy, destructor, and copy assignment.
+	// csr_edge_iterator (const csr_edge_iterator&);
+	// ~csr_edge_iterator ();
+	// csr_edge_iterator& operator = (const csr_edge_iterator&);
+
+	// ----------
+	// operator *
+	// ----------
+
+	/**
+	* dereference operator
+	* @return an edge descriptor for the Iterator's current state
+	*/
+	value_type operator * () const
+	{
+		assert(_index < _offsets[_n]);
+		return std::make_pair(_source, _targets[_index]);
+	}
+
+	// -----------
+	// operator ->
+	// -----------
+
+	/**
+	* pointer member access operator
+	* @return an edge descriptor for the Iterator's current state
+	*/
+	value_type operator -> () const
+	{
+		return **this;
+	}
+
+	// -----------
+	// operator ++
+	// -----------
+
+	/**
+	* Pre-increment Operator
+	* @return a Iterator reference incremented by 1
+	*/
+	csr_edge_iterator& operator ++ ()
+	{
+		++_index;
+		if(_index == _offsets[_n])
+			_source = _n;
+		else
+		{
+			while(_offsets[_source + 1] <= _index)
+				++_source;
+		}
+		assert(valid());
+		return *this;
+	}
+
+	/**
+	* Post-Increment Operator
+	* Does not effect the Iterator argument
+	* @return an Iterator incremented by 1
+	*/
+	csr_edge_iterator operator ++ (int)
+	{
+		csr_edge_iterator x = *this;
+		++(*this);
+		assert(valid());
+		return x;
+	}
+
+	// -----------
+	// operator --
+	// -----------
+
+	/**
+	* Pre-decrement Operator
+	* @return a Iterator reference decremented by 1
+	*/
+	csr_edge_iterator& operator -- ()
+	{
+		--_index;
+		while(_offsets[_source] > _index)
+			--_source;
+		assert(valid());
+		return *this;
+	}
+
+	/**
+	* Post-Decrement Operator
+	* Does not effect the Iterator argument
+	* @return an Iterator decremented by 1
+	*/
+	csr_edge_iterator operator -- (int)
+	{
+		csr_edge_iterator x = *this;
+		--(*this);
+		assert(valid());
+		return x;
+	}
+
+	// -----------
+	// operator +=
+	// -----------
+
+	/**
+	* Addition Assignent Operator
+	* @param d - the right hand side difference type
+	* @return a Iterator reference shifted forward by the difference_type value
+	*/
+	csr_edge_iterator& operator += (difference_type d)
+	{
+		seek(_index + d);
+		assert(valid());
+		return *this;
+	}
+
+	// -----------
+	// operator -=
+	// -----------
+
+	/**
+	* Subtraction Assignent Operator
+	* @param d - the right hand side difference type
+	* @return a Iterator reference shifted backward by the difference_type value
+	*/
+	csr_edge_iterator& operator -= (difference_type d)
+	{
+		seek(_index - d);
+		assert(valid());
+		return *this;
+	}
+};
+
+// --------
+// CSRGraph
+// --------
+
+///
+/// A class designed to represent a directed graph in compressed sparse row (CSR) form
+/// The adjacent vertices of vertex v are stored contiguously and in ascending order in targets[offsets[v]..offsets[v + 1]).
+/// The CSRGraph is meant to be built once, with the range constructor or from another graph, and then traversed many times.
+/// add_edge is supported for compatibility with the Graph interface, but it costs O(V + E).
+///
+class CSRGraph
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::size_t vertices_size_type;
+	typedef std::size_t edges_size_type;
+
+	typedef std::size_t vertex_descriptor;
+	typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor; // source, target
+
+	typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+	typedef std::vector<vertex_descriptor>::const_iterator adjacency_iterator;
+	typedef csr_edge_iterator<vertex_descriptor, edges_size_type> edge_iterator;
+
+public:
+	// --------
+	// add_edge
+	// --------
+
+	///
+    /// Add an edge between a source and target vertex to the graph
+    /// The new target is inserted into the source's row, which shifts every later row: O(V + E)
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a graph
+    /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor points to a new edge if the add_edge function was successful. Otherwise, the edge_descriptor points to the old edge already present in the graph. The bool value is true if the edge was successfully added. Otherwise, the bool value is false.
+    ///
+	friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor source, vertex_descriptor target, CSRGraph& graph)
+	{
+		edge_descriptor ed = std::make_pair(source, target);
+		if(std::max(source, target) >= num_vertices(graph))
+			graph.offsets.resize(std::max(source, target) + 2, graph.offsets.back());
+
+		std::vector<vertex_descriptor>::iterator b = graph.targets.begin() + graph.offsets[source];
+		std::vector<vertex_descriptor>::iterator e = graph.targets.begin() + graph.offsets[source + 1];
+		std::vector<vertex_descriptor>::iterator p = std::lower_bound(b, e, target);
+		if(p != e && *p == target)
+			return std::make_pair(ed, false);
+
+		graph.targets.insert(p, target);
+		for(vertices_size_type v = source + 1; v < graph.offsets.size(); ++v)
+			++graph.offsets[v];
+		assert(graph.valid());
+		return std::make_pair(ed, true);
+	}
+
+	// ----------
+	// add_vertex
+	// ----------
+
+	///
+    /// Add a vertex to the graph
+    /// @param graph - a graph
+    /// @return a vertex_descriptor representing the new vertex
+    ///
+	friend vertex_descriptor add_vertex (CSRGraph& graph)
+	{
+		graph.offsets.push_back(graph.offsets.back());
+		return graph.offsets.size() - 2;
+	}
+
+	// -----------------
+	// adjacent_vertices
+	// -----------------
+
+	///
+    /// Provide access to the adjacent vertices to the source vertex in the graph
+    /// For example, if an edge from vertex u to vertex v exists in the graph, the vertex v is an adjacent vertex.
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param graph - a graph
+    /// @return an iterator range representing the vertices adjacent to the source vertex in the graph
+    ///
+	friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor source, const CSRGraph& graph)
+	{
+		adjacency_iterator b = graph.targets.begin() + graph.offsets[source];
+		adjacency_iterator e = graph.targets.begin() + graph.offsets[source + 1];
+		return std::make_pair(b, e);
+	}
+
+	// ----
+	// edge
+	// ----
+
+	///
+    /// Find the edge between a source and target vertex to the graph with a binary search of the source's row
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a graph
+    /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor for the edge is returned regardless if the edge is present in the graph. The bool value is true if the edge is present. Otherwise, the bool value is false.
+    ///
+	friend std::pair<edge_descriptor, bool> edge (vertex_descriptor source, vertex_descriptor target, const CSRGraph& graph)
+	{
+		edge_descriptor ed = std::make_pair(source, target);
+		if(source < num_vertices(graph))
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(source, graph);
+			return std::make_pair(ed, std::binary_search(av.first, av.second, target));
+		}
+		return std::make_pair(ed, false);
+	}
+
+	// -----
+	// edges
+	// -----
+
+	///
+    /// Provide access to the edges in the graph
+    /// @param graph - a graph
+    /// @return an iterator range representing the edges in the graph
+    ///
+	friend std::pair<edge_iterator, edge_iterator> edges (const CSRGraph& graph)
+	{
+		edge_iterator b(graph.offsets.data(), graph.targets.data(), num_vertices(graph), 0);
+		edge_iterator e(graph.offsets.data(), graph.targets.data(), num_vertices(graph), graph.targets.size());
+		return std::make_pair(b, e);
+	}
+
+	// ---------
+	// num_edges
+	// ---------
+
+	///
+    /// Determine the number of edges in the graph
+    /// @param graph - a graph
+    /// @return the number of edges in the graph
+    ///
+	friend edges_size_type num_edges (const CSRGraph& graph)
+	{
+		return graph.targets.size();
+	}
+
+	// ------------
+	// num_vertices
+	// ------------
+
+	///
+    /// Determine the number of vertices in the graph
+    /// @param graph - a graph
+    /// @return the number of vertices in the graph
+    ///
+	friend vertices_size_type num_vertices (const CSRGraph& graph)
+	{
+		return graph.offsets.size() - 1;
+	}
+
+	// ------
+	// source
+	// ------
+
+    ///
+    /// Access the source vertex of an edge in a graph
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the source vertex
+    ///
+	friend vertex_descriptor source (edge_descriptor edge, const CSRGraph& graph)
+	{
+		return edge.first;
+	}
+
+	// ------
+	// target
+	// ------
+
+    ///
+    /// Access the target vertex of an edge in a graph
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the target vertex
+    ///
+	friend vertex_descriptor target (edge_descriptor edge, const CSRGraph& graph)
+	{
+		return edge.second;
+	}
+
+	// ------
+	// vertex
+	// ------
+
+    ///
+    /// Access the nth vertex of the graph
+    /// @param index - the nth position in the graph's vertex list
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the nth vertex in the graph's vertex list
+    ///
+	friend vertex_descriptor vertex (vertices_size_type index, const CSRGraph& graph)
+	{
+		return index;
+	}
+
+	// --------
+	// vertices
+	// --------
+
+    ///
+    /// Provide access to the vertices in the graph
+    /// @param graph - a graph
+    /// @return an iterator range representing the vertices in the graph
+    ///
+	friend std::pair<vertex_iterator, vertex_iterator> vertices (const CSRGraph& graph)
+	{
+		return std::make_pair(vertex_iterator(0), vertex_iterator(num_vertices(graph)));
+	}
+
+private:
+	// ----
+	// data
+	// ----
+	std::vector<edges_size_type> offsets; // Row offsets, one per vertex plus one
+	std::vector<vertex_descriptor> targets; // Adjacent vertices of every row, ascending within a row
+
+	// -----
+	// valid
+	// -----
+
+	///
+	/// @return true if the CSRGraph object is in a valid state
+	///
+	bool valid () const
+	{
+		return !offsets.empty() && offsets.front() == 0 && offsets.back() == targets.size();
+	}
+
+	// -----
+	// build
+	// -----
+
+	///
+	/// Fill the offsets and targets from an edge list sorted by source, then target, without duplicates
+	/// @param ed - the sorted, unique edge list
+	/// @param n - the minimum number of vertices of the graph
+	///
+	void build (const std::vector<edge_descriptor>& ed, vertices_size_type n)
+	{
+		if(!ed.empty())
+		{
+			for(const edge_descriptor& e : ed)
+				n = std::max(n, std::max(e.first, e.second) + 1);
+		}
+
+		offsets.assign(n + 1, 0);
+		targets.clear();
+		targets.reserve(ed.size());
+		for(const edge_descriptor& e : ed)
+		{
+			++offsets[e.first + 1];
+			targets.push_back(e.second);
+		}
+		for(vertices_size_type v = 0; v < n; ++v)
+			offsets[v + 1] += offsets[v];
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+    ///
+	/// Default Constructor - Empty Graph
+	///
+	CSRGraph () : offsets(1, 0)
+	{
+		assert(valid());
+	}
+
+	///
+	/// Range Constructor - Graph built from a list of edges
+	/// Duplicate edges are ignored
+	/// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+	/// @param b - the beginning of the edge list
+	/// @param e - the end of the edge list
+	/// @param n - the minimum number of vertices of the graph
+	///
+	template <typename II>
+	CSRGraph (II b, II e, vertices_size_type n = 0)
+	{
+		build(sorted_edges<edge_descriptor>(b, e, nullptr), n);
+		assert(valid());
+	}
+
+	///
+	/// Range Constructor - Graph built from a list of edges, sorting the edge list with every thread of the pool
+	/// Duplicate edges are ignored
+	/// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+	/// @param b - the beginning of the edge list
+	/// @param e - the end of the edge list
+	/// @param n - the minimum number of vertices of the graph
+	/// @param pool - the threads that sort the edge list
+	///
+	template <typename II>
+	CSRGraph (II b, II e, vertices_size_type n, ThreadPool& pool)
+	{
+		build(sorted_edges<edge_descriptor>(b, e, &pool), n);
+		assert(valid());
+	}
+
+	///
+	/// Conversion Constructor - Graph built from any graph with the Graph interface
+	/// @tparam G - Graph Class Template
+	/// @param graph - the graph to copy
+	///
+	template <typename G>
+	explicit CSRGraph (const G& graph) : offsets(1, 0)
+	{
+		offsets.reserve(num_vertices(graph) + 1);
+		targets.reserve(num_edges(graph));
+		std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
+		while(v.first != v.second)
+		{
+			std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(*v.first, graph);
+			std::vector<vertex_descriptor>::iterator b = targets.insert(targets.end(), av.first, av.second);
+			std::sort(b, targets.end());
+			targets.erase(std::unique(b, targets.end()), targets.end());
+			offsets.push_back(targets.size());
+			++v.first;
+		}
+		assert(valid());
+	}
+
+	///
+	/// Array Constructor - Graph that takes over arrays already in CSR form, without copying them
+	/// @param o - the row offsets, one per vertex plus one, starting at 0
+	/// @param t - the adjacent vertices of every row, ascending and unique within a row
+	///
+	CSRGraph (std::vector<edges_size_type>&& o, std::vector<vertex_descriptor>&& t) : offsets(std::move(o)), targets(std::move(t))
+	{
+		assert(valid());
+	}
+
+	// Default copy, destructor, and copy assignment
+	// CSRGraph  (const CSRGraph&);
+	// ~CSRGraph ();
+	// CSRGraph& operator = (const CSRGraph&);
+};
+
+#endif // CSRGraph_h
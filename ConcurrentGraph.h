@@ -0,0 +1,377 @@
+// --------------------------------
+// projects/graph/ConcurrentGraph.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef ConcurrentGraph_h
+#define ConcurrentGraph_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // copy, sort, unique
+#include <atomic> // atomic
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <mutex> // lock_guard, mutex
+#include <utility> // make_pair, move, pair
+#include <vector> // vector
+
+#include "CSRGraph.h" // CSRGraph
+#include "ThreadPool.h" // ThreadPool
+
+
+// ---------------
+// ConcurrentGraph
+// ---------------
+
+///
+/// A directed graph that many threads build at once, for ingest, and then freeze into a CSRGraph for traversal
+/// add_edge and add_vertex may be called from any number of threads without outside locking
+/// The vertices live in segments that are allocated as the graph grows and never move, each twice the size of the one before, so growing the graph does not invalidate a thread that is reading or writing a vertex
+/// Each vertex appends its targets to its own array, under one of a fixed set of lock stripes chosen by the source vertex, so threads that add edges from different sources rarely wait for each other
+/// The targets are kept in arrival order and may repeat; freeze sorts each array and removes the duplicates
+/// @tparam V - the vertex descriptor type
+///
+template <typename V = std::size_t>
+class ConcurrentGraph
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::size_t vertices_size_type;
+	typedef std::size_t edges_size_type;
+
+	typedef V vertex_descriptor;
+	typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor; // source, target
+
+private:
+	// ---------
+	// constants
+	// ---------
+
+	static const std::size_t first_bits = 10; // the first segment holds 2^first_bits vertices
+	static const std::size_t max_segments = 48; // enough segments for 2^(first_bits + max_segments - 1) vertices
+	static const std::size_t stripe_count = 1024; // the number of lock stripes, a power of two
+
+	///
+	/// A mutex alone on its cache line, so that threads that hold neighbouring stripes do not share a line
+	///
+	struct alignas(64) stripe
+	{
+		std::mutex lock;
+	};
+
+public:
+	// --------
+	// add_edge
+	// --------
+
+	///
+    /// Add an edge between a source and target vertex to the graph, from any thread
+    /// The graph grows to hold both vertices, and the target is appended to the source's array under the source's lock stripe
+    /// The edge is not checked against the edges already added; a duplicate is counted by num_edges until freeze removes it
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a graph
+    /// @return the edge_descriptor of the edge
+    ///
+	friend edge_descriptor add_edge (vertex_descriptor source, vertex_descriptor target, ConcurrentGraph& graph)
+	{
+		graph.grow(static_cast<vertices_size_type>(std::max(source, target)) + 1);
+		{
+			std::lock_guard<std::mutex> locked(graph.stripe_of(source));
+			graph.row(source).push_back(target);
+		}
+		graph.edgesize.fetch_add(1, std::memory_order_relaxed);
+		return std::make_pair(source, target);
+	}
+
+	// ----------
+	// add_vertex
+	// ----------
+
+	///
+    /// Add a vertex to the graph, from any thread
+    /// @param graph - a graph
+    /// @return a vertex_descriptor representing the new vertex, different from the one returned to any other thread
+    ///
+	friend vertex_descriptor add_vertex (ConcurrentGraph& graph)
+	{
+		vertices_size_type n = graph.size.load(std::memory_order_acquire);
+		do
+			graph.allocate(n + 1);
+		while(!graph.size.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+		return n;
+	}
+
+	// -------------
+	// read_adjacent
+	// -------------
+
+	///
+    /// Copy the targets added so far from a source vertex, from any thread, while other threads add edges
+    /// The targets are in arrival order, and may repeat
+    /// @tparam OI - Output Iterator Template
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param graph - a graph
+    /// @param x - an output iterator, which receives the targets
+    ///
+	template <typename OI>
+	friend void read_adjacent (vertex_descriptor source, const ConcurrentGraph& graph, OI x)
+	{
+		if(source >= graph.size.load(std::memory_order_acquire))
+			return;
+		std::lock_guard<std::mutex> locked(graph.stripe_of(source));
+		const std::vector<vertex_descriptor>& targets = graph.row(source);
+		std::copy(targets.begin(), targets.end(), x);
+	}
+
+	// ---------
+	// num_edges
+	// ---------
+
+	///
+    /// Determine the number of edges added to the graph, counting the duplicates until freeze removes them
+    /// @param graph - a graph
+    /// @return the number of edges
+    ///
+	friend edges_size_type num_edges (const ConcurrentGraph& graph)
+	{
+		return graph.edgesize.load(std::memory_order_relaxed);
+	}
+
+	// ------------
+	// num_vertices
+	// ------------
+
+	///
+    /// Determine the number of vertices in the graph
+    /// @param graph - a graph
+    /// @return the number of vertices
+    ///
+	friend vertices_size_type num_vertices (const ConcurrentGraph& graph)
+	{
+		return graph.size.load(std::memory_order_acquire);
+	}
+
+	// ------
+	// freeze
+	// ------
+
+	///
+    /// Move the edges of the graph into a CSRGraph with every thread of the pool, once no thread is adding to it
+    /// Each source's targets are sorted and deduplicated in parallel, the row offsets are summed, and the rows are copied into place in parallel
+    /// The graph keeps its vertices and loses its edges, so that its arrays are freed as they are copied
+    /// A Graph can be built from the result with its range constructor over edges(csr)
+    /// @param graph - a graph
+    /// @param pool - the threads that sort and copy the rows
+    /// @return a CSRGraph with the vertices and the unique edges of the graph
+    ///
+	friend CSRGraph freeze (ConcurrentGraph& graph, ThreadPool& pool)
+	{
+		typedef CSRGraph::edges_size_type csr_edges_size_type;
+		typedef CSRGraph::vertex_descriptor csr_vertex_descriptor;
+
+		const vertices_size_type n = graph.size.load(std::memory_order_acquire);
+		std::vector<csr_edges_size_type> offsets(n + 1, 0);
+		pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t v = b; v < e; ++v)
+			{
+				std::vector<vertex_descriptor>& targets = graph.row(v);
+				std::sort(targets.begin(), targets.end());
+				targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+				offsets[v + 1] = targets.size();
+			}
+		});
+		for(vertices_size_type v = 0; v != n; ++v)
+			offsets[v + 1] += offsets[v];
+
+		std::vector<csr_vertex_descriptor> targets(offsets[n]);
+		pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t v = b; v < e; ++v)
+			{
+				std::vector<vertex_descriptor>& adjacent = graph.row(v);
+				std::copy(adjacent.begin(), adjacent.end(), targets.begin() + offsets[v]);
+				std::vector<vertex_descriptor>().swap(adjacent);
+			}
+		});
+		graph.edgesize.store(0, std::memory_order_relaxed);
+		return CSRGraph(std::move(offsets), std::move(targets));
+	}
+
+	///
+    /// Move the edges of the graph into a CSRGraph, with one thread per hardware thread
+    /// @param graph - a graph
+    /// @return a CSRGraph with the vertices and the unique edges of the graph
+    ///
+	friend CSRGraph freeze (ConcurrentGraph& graph)
+	{
+		ThreadPool pool;
+		return freeze(graph, pool);
+	}
+
+private:
+	// ----
+	// data
+	// ----
+	std::atomic<vertices_size_type> size; // The number of vertices, published after the segments that hold them
+	std::atomic<edges_size_type> edgesize; // The number of edges added, with duplicates
+	std::atomic<std::vector<vertex_descriptor>*> segments[max_segments]; // The targets of each source, in segments of 2^first_bits, 2^first_bits, 2^(first_bits + 1), ... vertices
+	mutable stripe stripes[stripe_count]; // The locks of the arrays of targets, stripes[v % stripe_count] for source v
+
+private:
+	// -----
+	// valid
+	// -----
+
+	///
+	/// @return true if the ConcurrentGraph object is in a valid state
+	///
+	bool valid () const
+	{
+		return segments[0].load() != nullptr;
+	}
+
+	// ----------
+	// segment_of
+	// ----------
+
+	///
+	/// @param v - a vertex index
+	/// @return the segment that holds the vertex: 0 below 2^first_bits, and 1 + floor(log2(v / 2^first_bits)) above
+	///
+	static std::size_t segment_of (vertices_size_type v)
+	{
+		std::size_t k = 0;
+		for(v >>= first_bits; v != 0; v >>= 1)
+			++k;
+		return k;
+	}
+
+	// -------------
+	// segment_start
+	// -------------
+
+	///
+	/// @param k - a segment
+	/// @return the index of the first vertex of the segment, which is also the size of every segment but the first
+	///
+	static vertices_size_type segment_start (std::size_t k)
+	{
+		return k == 0 ? 0 : vertices_size_type(1) << (first_bits + k - 1);
+	}
+
+	// ---
+	// row
+	// ---
+
+	///
+	/// @param v - a vertex below num_vertices
+	/// @return the targets of the vertex
+	///
+	std::vector<vertex_descriptor>& row (vertices_size_type v) const
+	{
+		const std::size_t k = segment_of(v);
+		return segments[k].load(std::memory_order_acquire)[v - segment_start(k)];
+	}
+
+	// ---------
+	// stripe_of
+	// ---------
+
+	///
+	/// @param v - a vertex
+	/// @return the lock of the vertex's targets
+	///
+	std::mutex& stripe_of (vertices_size_type v) const
+	{
+		return stripes[v & (stripe_count - 1)].lock;
+	}
+
+	// --------
+	// allocate
+	// --------
+
+	///
+	/// Make sure that the segments for the first n vertices exist
+	/// Threads that need the same segment race to install it, and the losers free their copies
+	/// Every segment up to the last one is checked, since another thread may still be installing a lower one
+	/// @param n - a number of vertices
+	///
+	void allocate (vertices_size_type n)
+	{
+		if(n == 0)
+			return;
+		for(std::size_t k = 0; k <= segment_of(n - 1); ++k)
+		{
+			if(segments[k].load(std::memory_order_acquire) != nullptr)
+				continue;
+			std::vector<vertex_descriptor>* fresh = new std::vector<vertex_descriptor>[k == 0 ? segment_start(1) : segment_start(k)];
+			std::vector<vertex_descriptor>* expected = nullptr;
+			if(!segments[k].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+				delete[] fresh;
+		}
+	}
+
+	// ----
+	// grow
+	// ----
+
+	///
+	/// Raise the number of vertices to at least n, allocating their segments first
+	/// @param n - a number of vertices
+	///
+	void grow (vertices_size_type n)
+	{
+		vertices_size_type current = size.load(std::memory_order_acquire);
+		if(current >= n)
+			return;
+		allocate(n);
+		while(current < n && !size.compare_exchange_weak(current, n, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+		}
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - Empty Graph
+	///
+	ConcurrentGraph () : size(0), edgesize(0)
+	{
+		for(std::size_t k = 0; k != max_segments; ++k)
+			segments[k].store(nullptr, std::memory_order_relaxed);
+		allocate(1);
+		assert(valid());
+	}
+
+	///
+	/// Destructor - frees the segments
+	///
+	~ConcurrentGraph ()
+	{
+		for(std::size_t k = 0; k != max_segments; ++k)
+			delete[] segments[k].load(std::memory_order_relaxed);
+	}
+
+	ConcurrentGraph (const ConcurrentGraph&) = delete;
+	ConcurrentGraph& operator = (const ConcurrentGraph&) = delete;
+};
+
+template <typename V>
+const std::size_t ConcurrentGraph<V>::first_bits;
+template <typename V>
+const std::size_t ConcurrentGraph<V>::max_segments;
+template <typename V>
+const std::size_t ConcurrentGraph<V>::stripe_count;
+
+#endif // ConcurrentGraph_h
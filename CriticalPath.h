@@ -0,0 +1,268 @@
+// -----------------------------
+// projects/graph/CriticalPath.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef CriticalPath_h
+#define CriticalPath_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // copy, max
+#include <cstddef> // size_t
+#include <iterator> // iterator_traits
+#include <utility> // pair
+#include <vector> // vector
+
+#include "Graph.h" // topological_levels, topological_visit, transpose_adjacency
+#include "ThreadPool.h" // ThreadPool
+
+
+// ------------
+// dag_schedule
+// ------------
+
+///
+/// The schedule of a directed, acyclic graph of tasks, in which each vertex is a task with a cost and each edge (u, v) makes v wait for u to finish
+/// earliest[v] is the earliest time that v can start, the length of the longest path of costs that ends just before v
+/// latest[v] is the latest time that v can start without delaying the end of the schedule
+/// slack[v] is latest[v] - earliest[v], which is 0 on a critical path
+/// length is the time that the schedule takes, the length of the longest path of costs
+/// critical is a longest path of costs, from its first vertex to its last
+/// @tparam V - the vertex descriptor type
+/// @tparam W - the cost type
+///
+template <typename V, typename W>
+struct dag_schedule
+{
+	std::vector<W> earliest;
+	std::vector<W> latest;
+	std::vector<W> slack;
+	W length;
+	std::vector<V> critical;
+};
+
+// ---------------
+// finish_schedule
+// ---------------
+
+///
+/// A helper function for critical_path
+/// Fill the latest start and the slack of every vertex and the critical path from the earliest starts and the tails
+/// The tail of a vertex is the length of the longest path of costs that starts with it, so its latest start is the length of the schedule minus its tail
+/// The critical path starts at the smallest vertex without in-edges whose tail is the longest, and follows, from each vertex, the first adjacent vertex whose tail the vertex's tail was computed from
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a directed, acyclic graph
+/// @param cost - the cost of each vertex
+/// @param tail - the tail of each vertex
+/// @param first - the smallest vertex without in-edges whose tail is the longest
+/// @param s - the schedule, with the earliest starts, which receives the rest
+///
+template <typename G, typename RI>
+void finish_schedule (const G& graph, RI cost, const std::vector<typename std::iterator_traits<RI>::value_type>& tail, typename G::vertex_descriptor first, dag_schedule<typename G::vertex_descriptor, typename std::iterator_traits<RI>::value_type>& s)
+{
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef typename std::iterator_traits<RI>::value_type cost_type;
+
+	const std::size_t n = num_vertices(graph);
+	s.length = n == 0 ? cost_type() : tail[first];
+	s.latest.resize(n);
+	s.slack.resize(n);
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		s.latest[i] = s.length - tail[i];
+		s.slack[i] = s.latest[i] - s.earliest[i];
+	}
+
+	s.critical.clear();
+	if(n == 0)
+		return;
+	// tail[u] is cost[u] plus the tail of one adjacent vertex, and the same sum finds it again exactly
+	typename G::vertex_descriptor u = first;
+	while(true)
+	{
+		s.critical.push_back(u);
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		while(av.first != av.second && !(cost[u] + tail[*av.first] == tail[u]))
+			++av.first;
+		if(av.first == av.second)
+			break;
+		u = *av.first;
+	}
+}
+
+// -------------
+// critical_path
+// -------------
+
+///
+/// Schedule a directed, acyclic graph of tasks with nonnegative costs, in one depth-first search and one pass in topological order, in O(V + E) time
+/// The tail of each vertex is computed as topological_visit finishes it, when the tails of its adjacent vertices are known
+/// The earliest starts are then pushed along the edges, in the reverse of the order in which the vertices finished
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template, whose value_type is the cost type
+/// @param graph - a directed, acyclic graph
+/// @param cost - the cost of each vertex, cost[v] for vertex v
+/// @return the schedule
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename RI>
+dag_schedule<typename G::vertex_descriptor, typename std::iterator_traits<RI>::value_type> critical_path (const G& graph, RI cost)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef typename std::iterator_traits<RI>::value_type cost_type;
+
+	const std::size_t n = num_vertices(graph);
+	dag_schedule<vertex_descriptor, cost_type> s;
+	std::vector<cost_type> tail(n);
+	std::vector<vertex_descriptor> finished;
+	finished.reserve(n);
+	topological_visit(graph, [&] (vertex_descriptor u)
+	{
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		cost_type longest = cost_type();
+		for(bool first = true; av.first != av.second; ++av.first, first = false)
+		{
+			if(first || longest < tail[*av.first])
+				longest = tail[*av.first];
+		}
+		tail[u] = cost[u] + longest;
+		finished.push_back(u);
+	});
+
+	// The vertices that nothing has pushed to by their turn are the ones without in-edges
+	s.earliest.assign(n, cost_type());
+	std::vector<char> pushed(n, 0);
+	vertex_descriptor first = vertex_descriptor();
+	bool found = false;
+	for(typename std::vector<vertex_descriptor>::reverse_iterator p = finished.rbegin(); p != finished.rend(); ++p)
+	{
+		const vertex_descriptor u = *p;
+		if(!pushed[u])
+		{
+			if(!found || tail[first] < tail[u] || (!(tail[u] < tail[first]) && u < first))
+				first = u;
+			found = true;
+		}
+		const cost_type end = s.earliest[u] + cost[u];
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		for(; av.first != av.second; ++av.first)
+		{
+			s.earliest[*av.first] = std::max(s.earliest[*av.first], end);
+			pushed[*av.first] = 1;
+		}
+	}
+	finish_schedule(graph, cost, tail, first, s);
+	return s;
+}
+
+///
+/// Schedule a directed, acyclic graph of tasks with nonnegative costs with every thread of the pool, one topological level at a time
+/// The vertices of a level do not depend on each other, so the tails are computed from the last level to the first, and the earliest starts from the first level to the last, each level in parallel
+/// Each vertex reads its own in-edges for its earliest start, from transpose_adjacency, so no two threads write the same vertex
+/// This pays for the levels and the in-edges when the levels are wide enough to keep the threads busy
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template, whose value_type is the cost type
+/// @param graph - a directed, acyclic graph
+/// @param cost - the cost of each vertex, cost[v] for vertex v
+/// @param pool - the threads that compute the schedule
+/// @return the schedule, the same as the serial critical_path
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename RI>
+dag_schedule<typename G::vertex_descriptor, typename std::iterator_traits<RI>::value_type> critical_path (const G& graph, RI cost, ThreadPool& pool)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef typename std::iterator_traits<RI>::value_type cost_type;
+
+	const std::size_t n = num_vertices(graph);
+	const std::vector<std::vector<vertex_descriptor> > levels = topological_levels(graph, pool);
+	std::vector<std::size_t> in_offsets;
+	std::vector<vertex_descriptor> in_sources;
+	transpose_adjacency(graph, in_offsets, in_sources, pool);
+
+	dag_schedule<vertex_descriptor, cost_type> s;
+	std::vector<cost_type> tail(n);
+	for(std::size_t d = levels.size(); d-- != 0; )
+	{
+		const std::vector<vertex_descriptor>& level = levels[d];
+		pool.parallel_for(0, level.size(), [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t i = b; i < e; ++i)
+			{
+				const vertex_descriptor u = level[i];
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+				cost_type longest = cost_type();
+				for(bool first = true; av.first != av.second; ++av.first, first = false)
+				{
+					if(first || longest < tail[*av.first])
+						longest = tail[*av.first];
+				}
+				tail[u] = cost[u] + longest;
+			}
+		});
+	}
+
+	s.earliest.resize(n);
+	for(const std::vector<vertex_descriptor>& level : levels)
+	{
+		pool.parallel_for(0, level.size(), [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t i = b; i < e; ++i)
+			{
+				const vertex_descriptor v = level[i];
+				cost_type start = cost_type();
+				for(std::size_t j = in_offsets[v]; j != in_offsets[v + 1]; ++j)
+				{
+					const vertex_descriptor u = in_sources[j];
+					if(j == in_offsets[v] || start < s.earliest[u] + cost[u])
+						start = s.earliest[u] + cost[u];
+				}
+				s.earliest[v] = start;
+			}
+		});
+	}
+
+	// The vertices without in-edges are the first level, in ascending order
+	vertex_descriptor first = vertex_descriptor();
+	if(!levels.empty())
+	{
+		for(vertex_descriptor u : levels.front())
+		{
+			if(u == levels.front().front() || tail[first] < tail[u])
+				first = u;
+		}
+	}
+	finish_schedule(graph, cost, tail, first, s);
+	return s;
+}
+
+// ----------------
+// dag_longest_path
+// ----------------
+
+///
+/// Find a longest path of nonnegative vertex costs in a directed, acyclic graph, in O(V + E) time
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template, whose value_type is the cost type
+/// @tparam OI - Output Iterator Template
+/// @param graph - a directed, acyclic graph
+/// @param cost - the cost of each vertex, cost[v] for vertex v
+/// @param x - an output iterator, which receives the vertices of the path from the first to the last
+/// @return the length of the path, the sum of the costs of its vertices
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename RI, typename OI>
+typename std::iterator_traits<RI>::value_type dag_longest_path (const G& graph, RI cost, OI x)
+{
+	dag_schedule<typename G::vertex_descriptor, typename std::iterator_traits<RI>::value_type> s = critical_path(graph, cost);
+	std::copy(s.critical.begin(), s.critical.end(), x);
+	return s.length;
+}
+
+#endif // CriticalPath_h
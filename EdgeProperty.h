@@ -0,0 +1,226 @@
+// -----------------------------
+// projects/graph/EdgeProperty.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef EdgeProperty_h
+#define EdgeProperty_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // lower_bound, stable_sort
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <iterator> // distance
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+
+// -----------------
+// edge_property_map
+// -----------------
+
+///
+/// A value for every edge of a graph, such as a weight, kept outside the graph in one array
+/// The values of the edges from vertex u are values[offsets[u]] through values[offsets[u + 1] - 1], in the order of adjacent_vertices(u, graph), which is ascending for every graph here
+/// So an algorithm that walks the adjacent vertices of u walks row(u) beside them, and the graph's nodes carry no values
+/// The map does not follow changes to the graph; it is built for a graph that is no longer modified, such as a CSRGraph
+/// @tparam T - the value type
+///
+template <typename T>
+class edge_property_map
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef T value_type;
+	typedef typename std::vector<T>::const_iterator const_iterator;
+	typedef typename std::vector<T>::iterator iterator;
+
+private:
+	// ----
+	// data
+	// ----
+	std::vector<std::size_t> offsets; // Row offsets, one per vertex plus one
+	std::vector<T> values; // Values of the edges, by source, in adjacency order
+
+private:
+	// -----
+	// valid
+	// -----
+
+	///
+	/// @return true if the edge_property_map object is in a valid state
+	///
+	bool valid () const
+	{
+		return !offsets.empty() && offsets.front() == 0 && offsets.back() == values.size();
+	}
+
+	// -----------
+	// count_edges
+	// -----------
+
+	///
+	/// Fill the row offsets from the out-degrees of the graph
+	/// @tparam G - Graph Class Template
+	/// @param graph - a graph
+	///
+	template <typename G>
+	void count_edges (const G& graph)
+	{
+		typedef typename G::adjacency_iterator adjacency_iterator;
+		const std::size_t n = num_vertices(graph);
+		offsets.assign(n + 1, 0);
+		for(std::size_t i = 0; i != n; ++i)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			offsets[i + 1] = offsets[i] + std::distance(av.first, av.second);
+		}
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - the map of a graph without vertices
+	///
+	edge_property_map () : offsets(1, 0)
+	{
+		assert(valid());
+	}
+
+	///
+	/// Constructor - every edge of the graph gets a value from a function of its endpoints
+	/// @tparam G - Graph Class Template
+	/// @tparam F - Function Template, called as f(source, target)
+	/// @param graph - a graph
+	/// @param f - the function that gives the value of each edge
+	///
+	template <typename G, typename F>
+	edge_property_map (const G& graph, F f)
+	{
+		typedef typename G::adjacency_iterator adjacency_iterator;
+		count_edges(graph);
+		values.reserve(offsets.back());
+		for(std::size_t i = 0; i + 1 < offsets.size(); ++i)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			for(; av.first != av.second; ++av.first)
+				values.push_back(f(vertex(i, graph), *av.first));
+		}
+		assert(valid());
+	}
+
+	///
+	/// Constructor - the edges of the graph get their values from a list of edges with values, as the graph was built from
+	/// The list is sorted once, and each row of the graph is merged with its part of the list
+	/// An edge listed more than once gets its first value, an edge that is not listed gets missing, and a listed edge that is not in the graph is ignored
+	/// @tparam G - Graph Class Template
+	/// @tparam II - Input Iterator Template, whose value_type is a std::pair of an edge descriptor and a value
+	/// @param graph - a graph
+	/// @param b - the beginning of the list
+	/// @param e - the end of the list
+	/// @param missing - the value of the edges that are not listed
+	///
+	template <typename G, typename II>
+	edge_property_map (const G& graph, II b, II e, const T& missing = T())
+	{
+		typedef typename G::vertex_descriptor vertex_descriptor;
+		typedef typename G::adjacency_iterator adjacency_iterator;
+		typedef std::pair<std::pair<vertex_descriptor, vertex_descriptor>, T> listed_edge;
+
+		std::vector<listed_edge> ed(b, e);
+		std::stable_sort(ed.begin(), ed.end(), [] (const listed_edge& x, const listed_edge& y) -> bool
+		{
+			return x.first < y.first;
+		});
+		count_edges(graph);
+		values.reserve(offsets.back());
+		typename std::vector<listed_edge>::const_iterator p = ed.begin();
+		for(std::size_t i = 0; i + 1 < offsets.size(); ++i)
+		{
+			const vertex_descriptor u = vertex(i, graph);
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+			for(; av.first != av.second; ++av.first)
+			{
+				const std::pair<vertex_descriptor, vertex_descriptor> key(u, *av.first);
+				while(p != ed.end() && p->first < key)
+					++p;
+				values.push_back(p != ed.end() && p->first == key ? p->second : missing);
+			}
+		}
+		assert(valid());
+	}
+
+	// Default copy, destructor, and copy assignment
+	// edge_property_map (const edge_property_map&);
+	// ~edge_property_map ();
+	// edge_property_map& operator = (const edge_property_map&);
+
+	// ---
+	// row
+	// ---
+
+	///
+	/// @param source - the index of a vertex
+	/// @return the values of the edges from the vertex, in the order of its adjacent vertices
+	///
+	std::pair<const_iterator, const_iterator> row (std::size_t source) const
+	{
+		return std::make_pair(values.begin() + offsets[source], values.begin() + offsets[source + 1]);
+	}
+
+	///
+	/// @param source - the index of a vertex
+	/// @return the values of the edges from the vertex, in the order of its adjacent vertices
+	///
+	std::pair<iterator, iterator> row (std::size_t source)
+	{
+		return std::make_pair(values.begin() + offsets[source], values.begin() + offsets[source + 1]);
+	}
+
+	// ----
+	// size
+	// ----
+
+	///
+	/// @return the number of edges with a value
+	///
+	std::size_t size () const
+	{
+		return values.size();
+	}
+};
+
+// ----------
+// edge_value
+// ----------
+
+///
+/// Find the value of one edge, by its position among the adjacent vertices of its source, in O(log d) time for a graph with random access adjacency and O(d) otherwise
+/// @tparam T - the value type
+/// @tparam G - Graph Class Template
+/// @param map - the values of the edges of the graph
+/// @param source - the source of the edge
+/// @param target - the target of the edge, which must be an edge of the graph
+/// @param graph - a graph
+/// @return the value of the edge
+///
+template <typename T, typename G>
+const T& edge_value (const edge_property_map<T>& map, typename G::vertex_descriptor source, typename G::vertex_descriptor target, const G& graph)
+{
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(source, graph);
+	const adjacency_iterator p = std::lower_bound(av.first, av.second, target);
+	assert(p != av.second && *p == target);
+	return *(map.row(source).first + std::distance(av.first, p));
+}
+
+#endif // EdgeProperty_h
@@ -12,39 +12,157 @@
 // --------
 #include <boost/throw_exception.hpp>
 #include <boost/graph/exception.hpp>
+#include <boost/iterator/counting_iterator.hpp>
 #include <exception> // exception
 #include <stddef.h> // ptrdiff_t
 #include <cassert> // assert
 #include <cstddef> // size_t
-#include <utility> // make_pair, pair
+#include <algorithm> // copy, is_sorted, max, sort, unique, upper_bound
+#include <iterator> // advance, bidirectional_iterator_tag
+#include <type_traits> // is_same
+#include <limits> // numeric_limits
+#include <memory> // allocator_traits, make_shared, shared_ptr
+#include <stdexcept> // out_of_range
+#include <utility> // make_pair, move, pair, swap
 #include <vector> // vector
-#include <stack> // stack
-#include <queue> // heap
-#include <functional> // greater
+#include <set> // set
+#include <functional> // less
+#include <unordered_map> // unordered_map
+#include <atomic> // atomic
+#include <mutex> // mutex, lock_guard
 
+#include "AdjacencyIndex.h" // adjacency_index
+#include "ArenaAllocator.h" // arena_allocator
+#include "GraphTrace.h" // GRAPH_TRACE_COUNT, GRAPH_TRACE_DEPTH, GRAPH_TRACE_PHASE
+#include "SortedVector.h" // sorted_vector
+#include "ThreadPool.h" // ThreadPool, parallel_sort
 
-// -----
-// Graph
-// -----
+
+// ------------
+// sorted_edges
+// ------------
+
+///
+/// Copy an edge list, then sort it by source and target and remove the duplicate edges
+/// This is the first step of the bulk construction of a graph
+/// @tparam ED - Edge Descriptor Template, a std::pair of vertex descriptors
+/// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+/// @param b - the beginning of the edge list
+/// @param e - the end of the edge list
+/// @param pool - if not null, the threads that sort the edge list
+/// @return the sorted, unique edge list
+///
+template <typename ED, typename II>
+std::vector<ED> sorted_edges (II b, II e, ThreadPool* pool) 
+{
+	std::vector<ED> ed(b, e);
+	if(pool != nullptr)
+		parallel_sort(*pool, ed.begin(), ed.end());
+	else
+		std::sort(ed.begin(), ed.end());
+	ed.erase(std::unique(ed.begin(), ed.end()), ed.end());
+	return ed;
+}
+
+// ---------
+// selectors
+// ---------
+
+///
+/// The out-edge container selectors of basic_graph
+/// ordered_setS stores the adjacent vertices of a vertex in a std::set, with O(log d) insertions
+/// sorted_vecS stores them in a sorted_vector, which takes a fraction of the memory and scans faster, but has O(d) insertions out of order
+///
+struct ordered_setS
+{
+	template <typename V, typename A>
+	struct bind
+	{
+		typedef std::set<V, std::less<V>, A> type;
+	};
+};
+
+struct sorted_vecS
+{
+	template <typename V, typename A>
+	struct bind
+	{
+		typedef sorted_vector<V, A> type;
+	};
+};
+
+///
+/// The direction selectors of basic_graph, which play the part of boost::directedS and boost::bidirectionalS
+/// A bidirectional_edgesS graph also stores the sources of the in-edges of every vertex, for in_edges, in_degree, and inv_adjacent_vertices, at the cost of a second adjacency set per vertex
+/// They are not the boost types, so that argument-dependent lookup does not bring the boost graph algorithms into calls on a basic_graph
+///
+struct directed_edgesS
+{};
+
+struct bidirectional_edgesS
+{};
+
+// ----------------
+// reserve_adjacent
+// ----------------
+
+///
+/// Prepare an adjacency container for a number of adjacent vertices
+/// A std::set allocates its nodes one by one, so there is nothing to prepare
+/// @param adjacent - an adjacency container
+/// @param n - the number of adjacent vertices that it will hold
+///
+template <typename V, typename C, typename A>
+void reserve_adjacent (std::set<V, C, A>& adjacent, std::size_t n)
+{}
+
+template <typename V, typename A>
+void reserve_adjacent (sorted_vector<V, A>& adjacent, std::size_t n)
+{
+	adjacent.reserve(n);
+}
+
+// -----------
+// basic_graph
+// -----------
 
 ///
 /// A class designed to represent a directed graph
+/// The adjacency sets allocate their memory with A, which by default is an arena_allocator: the nodes of a graph are bump-allocated from one Arena, and released with it in a few frees
+/// The Arena keeps its chunks until it is destroyed, so with the default allocator removing edges or vertices makes the freed nodes reusable by the graph but does not shrink its memory; compact, or a copy of the graph, moves the adjacency sets to a new Arena sized to the edges
+/// A graph with fewer than 2^32 vertices can use std::uint32_t vertex descriptors, and together with sorted_vecS that roughly halves its memory
+/// @tparam V - the vertex descriptor type, an unsigned integer type
+/// @tparam S - the out-edge container selector, ordered_setS or sorted_vecS
+/// @tparam A - the allocator of the adjacency sets, rebound to the vertex descriptor type
+/// @tparam D - the direction selector, directed_edgesS, or bidirectional_edgesS to also store the in-edges of every vertex
 ///
-class Graph 
+template <typename V = std::size_t, typename S = ordered_setS, typename A = arena_allocator<V>, typename D = directed_edgesS>
+class basic_graph 
 {
 public:
+	// ---------
+	// constants
+	// ---------
+
+	static const bool bidirectional = std::is_same<D, bidirectional_edgesS>::value;
+
 	// --------
 	// typedefs
 	// --------
 
 	typedef std::size_t vertices_size_type;
 	typedef std::size_t edges_size_type;
+	typedef std::size_t degree_size_type;
 
-	typedef std::size_t vertex_descriptor;
-	typedef std::pair<vertex_descriptor, edges_size_type> edge_descriptor; // source, target
+	typedef V vertex_descriptor;
+	typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor; // source, target
 
-	typedef std::vector<vertex_descriptor>::const_iterator vertex_iterator;
-	typedef std::set<vertex_descriptor>::const_iterator adjacency_iterator;
+	typedef typename std::allocator_traits<A>::template rebind_alloc<vertex_descriptor> allocator_type;
+	typedef typename S::template bind<vertex_descriptor, allocator_type>::type adjacency_set;
+
+	typedef boost::counting_iterator<vertex_descriptor> vertex_iterator; // Random access, with no storage behind it
+	typedef typename adjacency_set::const_iterator adjacency_iterator;
+	typedef typename adjacency_set::const_iterator inv_adjacency_iterator;
 
 
 public:
@@ -54,6 +172,11 @@ public:
 
 	///
 	/// A modifiable bidirectional edge_iterator for the Graph class
+	/// The iterator caches its source vertex and position in the source's adjacency list,
+	/// so dereference, increment, and decrement are amortized O(1).
+	/// The iterators of one edges(graph) range share the prefix-sum edge offsets that edges built,
+	/// so jumps with += and -= find the new source vertex with a binary search, and never write to the Graph.
+	/// Adding or removing an edge or a vertex invalidates every edge_iterator of the Graph.
 	///
 	class edge_iterator 
 	{
@@ -129,8 +252,11 @@ public:
 		// ----
 		// data
 		// ----
-		const Graph* _g;
+		const basic_graph* _g;
+		std::shared_ptr<const std::vector<edges_size_type> > _offsets; // offsets[v] is the index of the first edge whose source is v
 		edges_size_type    _index;
+		vertex_descriptor  _source;
+		adjacency_iterator _position;
 
 	private:
 		// -----
@@ -142,7 +268,32 @@ public:
 		*/
 		bool valid () const 
 		{
-			return (_g == nullptr && _index == 0) || _index >= 0;
+			return (_g == nullptr && _index == 0) || (_g != nullptr && _offsets->size() == _g->g.size() + 1 && _index <= _g->edgesize && _source <= _g->g.size());
+		}
+
+		// ----
+		// seek
+		// ----
+
+		/**
+		* Move the Iterator to the edge at position i in the Graph's edge order
+		* The source vertex is found with a binary search over the prefix-sum edge offsets, in O(log V) time
+		* The offsets are only read, so Iterators of one Graph can seek on several threads at once
+		* @param i - the new index state for the Iterator
+		*/
+		void seek (edges_size_type i) 
+		{
+			_index = i;
+			if(_index >= _g->edgesize)
+			{
+				_source = _g->g.size();
+				return;
+			}
+
+			const std::vector<edges_size_type>& offsets = *_offsets;
+			_source = std::upper_bound(offsets.begin(), offsets.end(), _index) - offsets.begin() - 1;
+			_position = _g->g[_source].begin();
+			std::advance(_position, _index - offsets[_source]);
 		}
 
 	public:
@@ -154,9 +305,24 @@ public:
 		* Create an Iterator object using the Graph container
 		* @param g - a pointer to the Graph container
 		* @param i - index state for the Iterator
+		* @param offsets - the prefix-sum edge offsets of the Graph, which are built if they are not given
 		*/
-		edge_iterator (const Graph* g = nullptr, std::size_t i = 0) : _g(g), _index(i)
+		edge_iterator (const basic_graph* g = nullptr, std::size_t i = 0, std::shared_ptr<const std::vector<edges_size_type> > offsets = nullptr) : _g(g), _offsets(std::move(offsets)), _index(0), _source(0), _position()
 		{
+			if(_g != nullptr)
+			{
+				if(!_offsets)
+					_offsets = _g->edge_offsets();
+				if(i == 0 && _g->edgesize != 0)
+				{
+					// The first edge belongs to the first non-empty adjacency list
+					while(_g->g[_source].empty())
+						++_source;
+					_position = _g->g[_source].begin();
+				}
+				else
+					seek(i);
+			}
 			assert(valid());
 		}
 
@@ -175,19 +341,8 @@ public:
 		*/
 		value_type operator * () const 
 		{
-			assert(_index <= _g->edgesize); 
-			edges_size_type offset = _index;
-			vertex_descriptor source = 0;
-			while(offset >= _g->g[source].size())
-			{
-				offset -= _g->g[source].size();
-				++source;
-			}
-
-			adjacency_iterator av = _g->g[source].begin();
-			for(size_t i = 0; i < offset; ++i)
-				++av;
-			return std::make_pair(source, *av);
+			assert(_index < _g->edgesize); 
+			return std::make_pair(_source, *_position);
 		}
 
 		// -----------
@@ -214,6 +369,14 @@ public:
 		edge_iterator& operator ++ () 
 		{
 			++_index;
+			if(_index == _g->edgesize)
+				_source = _g->g.size();
+			else
+			{
+				++_position;
+				while(_position == _g->g[_source].end())
+					_position = _g->g[++_source].begin();
+			}
 			assert(valid());
 			return *this;
 		}
@@ -241,6 +404,12 @@ public:
 		*/
 		edge_iterator& operator -- () 
 		{
+			while(_source == _g->g.size() || _position == _g->g[_source].begin())
+			{
+				--_source;
+				_position = _g->g[_source].end();
+			}
+			--_position;
 			--_index;
 			assert(valid());
 			return *this;
@@ -270,7 +439,8 @@ public:
 		*/
 		edge_iterator& operator += (difference_type d) 
 		{
-			_index += d;
+			if(d != 0)
+				seek(_index + d);
 			assert(valid());
 			return *this;
 		}
@@ -286,12 +456,147 @@ public:
 		*/
 		edge_iterator& operator -= (difference_type d) 
 		{
-			_index -= d;
+			if(d != 0)
+				seek(_index - d);
 			assert(valid());
 			return *this;
 		}
 	};
 
+	// ----------------
+	// in_edge_iterator
+	// ----------------
+
+	///
+	/// A bidirectional iterator over the in-edges of one vertex of a bidirectional graph
+	/// It walks the in-edge set of the vertex, and pairs each source with the vertex
+	///
+	class in_edge_iterator 
+	{
+	public:
+		// --------
+		// typedefs
+		// --------
+
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef edge_descriptor		value_type;
+		typedef ptrdiff_t			difference_type;
+		typedef edge_descriptor*	pointer;
+		typedef edge_descriptor		reference;
+
+	public:
+		// -----------
+		// operator ==
+		// -----------
+
+		/**
+		* equal operator
+		* @param lhs - the left hand side Iterator
+		* @param rhs - the right hand side Iterator
+		* @return true if the lhs Iterator is equal to the rhs Iterator
+		*/
+		friend bool operator == (const in_edge_iterator& lhs, const in_edge_iterator& rhs) 
+		{
+			return lhs._position == rhs._position;
+		}
+
+		/**
+		* not equal operator
+		* @param lhs - the left hand side Iterator
+		* @param rhs - the right hand side Iterator
+		* @return true if the lhs Iterator is not equal to the rhs Iterator
+		*/
+		friend bool operator != (const in_edge_iterator& lhs, const in_edge_iterator& rhs) 
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		// ----
+		// data
+		// ----
+		inv_adjacency_iterator _position;
+		vertex_descriptor _target;
+
+	public:
+		// -----------
+		// constructor
+		// -----------
+
+		/**
+		* Create an Iterator object over the in-edges of a vertex
+		* @param position - a position in the in-edge set of the target
+		* @param target - the target vertex of the in-edges
+		*/
+		in_edge_iterator (inv_adjacency_iterator position = inv_adjacency_iterator(), vertex_descriptor target = 0) : _position(position), _target(target)
+		{}
+
+		// Default copy, destructor, and copy assignment.
+
+		// ----------
+		// operator *
+		// ----------
+
+		/**
+		* dereference operator
+		* @return the edge from the current source to the target
+		*/
+		reference operator * () const 
+		{
+			return std::make_pair(*_position, _target);
+		}
+
+		// -----------
+		// operator ++
+		// -----------
+
+		/**
+		* pre-increment operator
+		* @return a reference to the Iterator moved to the next in-edge
+		*/
+		in_edge_iterator& operator ++ () 
+		{
+			++_position;
+			return *this;
+		}
+
+		/**
+		* post-increment operator
+		* @return a copy of the Iterator before the increment
+		*/
+		in_edge_iterator operator ++ (int) 
+		{
+			in_edge_iterator x = *this;
+			++*this;
+			return x;
+		}
+
+		// -----------
+		// operator --
+		// -----------
+
+		/**
+		* pre-decrement operator
+		* @return a reference to the Iterator moved to the previous in-edge
+		*/
+		in_edge_iterator& operator -- () 
+		{
+			--_position;
+			return *this;
+		}
+
+		/**
+		* post-decrement operator
+		* @return a copy of the Iterator before the decrement
+		*/
+		in_edge_iterator operator -- (int) 
+		{
+			in_edge_iterator x = *this;
+			--*this;
+			return x;
+		}
+	};
+
 public:
 	// --------
 	// add_edge
@@ -304,33 +609,68 @@ public:
     /// @param graph - a graph
     /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor points to a new edge if the add_edge function was successful. Otherwise, the edge_descriptor points to the old edge already present in the graph. The bool value is true if the edge was successfully added. Otherwise, the bool value is false. 
     ///
-	friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor source, vertex_descriptor target, Graph& graph) 
+	friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor source, vertex_descriptor target, basic_graph& graph) 
 	{
 		std::pair<edge_descriptor, bool> isPresent = edge(source, target, graph);
 		if(isPresent.second)
 		{
 			return std::make_pair(isPresent.first, false);
 		}
-		else if(source >= std::numeric_limits<size_t>::max() && target >= std::numeric_limits<size_t>::max())
+		else if(source >= std::numeric_limits<vertex_descriptor>::max() && target >= std::numeric_limits<vertex_descriptor>::max())
 		{
 			throw std::out_of_range("vertex_descriptor source and target are invalid values");
 		}
 		else
 		{
-			if(std::max(source, target) >= graph.vertices.size())
-			{
-				size_t newsize = std::max(source, target) - graph.vertices.size();
-				for(size_t i = 0; i < newsize + 1; ++i)
-					add_vertex(graph);
-			}
+			graph.grow(static_cast<vertices_size_type>(std::max(source, target)) + 1);
+			graph.revive(source);
+			graph.revive(target);
 
 			++graph.edgesize;
 			edge_descriptor ed = std::make_pair(source, target);
 			graph.g[source].insert(target);
+			graph.index_edge(source, target);
+			if(bidirectional)
+				graph.in[target].insert(source);
 			return std::make_pair(ed, true);
 		}
 	}
 
+	// ----------------
+	// build_from_edges
+	// ----------------
+
+	///
+    /// Add a list of edges to the graph in bulk
+    /// The edge list is sorted and deduplicated once, the vertex storage is sized once, and each target is inserted at the end of its source's adjacency list
+    /// Edges already present in the graph and duplicate edges in the list are ignored
+    /// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+    /// @param b - the beginning of the edge list
+    /// @param e - the end of the edge list
+    /// @param n - the minimum number of vertices of the graph after the construction
+    /// @param graph - a graph
+    ///
+	template <typename II>
+	friend void build_from_edges (II b, II e, vertices_size_type n, basic_graph& graph) 
+	{
+		graph.insert_sorted(sorted_edges<edge_descriptor>(b, e, nullptr), n);
+	}
+
+	///
+    /// Add a list of edges to the graph in bulk, sorting the edge list with every thread of the pool
+    /// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+    /// @param b - the beginning of the edge list
+    /// @param e - the end of the edge list
+    /// @param n - the minimum number of vertices of the graph after the construction
+    /// @param graph - a graph
+    /// @param pool - the threads that sort the edge list
+    ///
+	template <typename II>
+	friend void build_from_edges (II b, II e, vertices_size_type n, basic_graph& graph, ThreadPool& pool) 
+	{
+		graph.insert_sorted(sorted_edges<edge_descriptor>(b, e, &pool), n);
+	}
+
 	// ----------
 	// add_vertex
 	// ----------
@@ -340,116 +680,343 @@ public:
     /// @param graph - a graph
     /// @return a vertex_descriptor representing the new vertex
     ///
-	friend vertex_descriptor add_vertex (Graph& graph) 
+	friend vertex_descriptor add_vertex (basic_graph& graph) 
 	{
-		graph.g.push_back(std::set<vertex_descriptor>());
-		graph.vertices.push_back(graph.g.size() - 1);
+		graph.grow(graph.g.size() + 1);
 		return graph.g.size() - 1;
 	}
 
-	// -----------------
-	// adjacent_vertices
-	// -----------------
+	// -----------
+	// remove_edge
+	// -----------
 
 	///
-    /// Provide access to the adjacent vertices to the source vertex in the graph
-    /// For example, if an edge from vertex u to vertex v exists in the graph, the vertex v is an adjacent vertex.
+    /// Remove the edge between a source and target vertex from the graph, if it is present
+    /// The edge is erased from the source's adjacency set in O(log d) time for an ordered_setS graph
+    /// A sorted_vecS graph shifts the rest of the row instead, in O(d) time, which is not O(log d): use ordered_setS for a graph whose edges are removed often
     /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
     /// @param graph - a graph
-    /// @return an iterator range representing the vertices adjacent to the source vertex in the graph
     ///
-	friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor source, const Graph& graph) 
+	friend void remove_edge (vertex_descriptor source, vertex_descriptor target, basic_graph& graph) 
 	{
-		adjacency_iterator b = graph.g[source].begin();
-		adjacency_iterator e = graph.g[source].end();
-		return std::make_pair(b, e);
+		graph.erase_edge(source, target);
 	}
 
-	// ----
-	// edge
-	// ----
+	///
+    /// Remove an edge from the graph, if it is present
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    ///
+	friend void remove_edge (edge_descriptor edge, basic_graph& graph) 
+	{
+		graph.erase_edge(edge.first, edge.second);
+	}
+
+	// ------------
+	// clear_vertex
+	// ------------
 
 	///
-    /// Find the edge between a source and target vertex to the graph
-    /// @param source - a vertex descriptor for the source vertex
-    /// @param target - a vertex descriptor for the target vertex
+    /// Remove every edge into or out of a vertex
+    /// A directed graph does not store in-edges, so every adjacency set is searched for the vertex: this takes O(V log d) time, or O(V d) for sorted_vecS, however few edges the vertex has
+    /// A bidirectional graph, such as BidirectionalGraph, finds the in-edges in its in-edge sets and visits only the edges of the vertex, in O(deg log d) time: use one to remove vertices in time bounded by their degree
+    /// @param u - a vertex descriptor
     /// @param graph - a graph
-    /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor for the edge is returned regardless if the edge is present in the graph. The bool value is true if the edge is present. Otherwise, the bool value is false. 
     ///
-	friend std::pair<edge_descriptor, bool> edge (vertex_descriptor source, vertex_descriptor target, const Graph& graph) 
+	friend void clear_vertex (vertex_descriptor u, basic_graph& graph) 
 	{
-		if(source < graph.g.size())
+		if(u >= graph.g.size())
+			return;
+		if(bidirectional)
 		{
-			for(vertex_descriptor i : graph.g[source])
+			for(vertex_descriptor w : graph.g[u])
 			{
-				if(i == target)
-					return std::make_pair(std::make_pair(source, target), true);
+				if(w != u)
+					graph.in[w].erase(u);
 			}
+			graph.in[u].erase(u);
+		}
+		graph.edgesize -= graph.g[u].size();
+		graph.g[u].clear();
+		graph.hubs.erase(u);
+		if(bidirectional)
+		{
+			const std::vector<vertex_descriptor> sources(graph.in[u].begin(), graph.in[u].end());
+			for(vertex_descriptor v : sources)
+				graph.erase_edge(v, u);
+		}
+		else
+		{
+			for(vertex_descriptor v = 0; v != graph.g.size(); ++v)
+				graph.erase_edge(v, u);
 		}
-		return std::make_pair(std::make_pair(source, target), false);
 	}
 
-	// -----
-	// edges
-	// -----
+	// -------------
+	// remove_vertex
+	// -------------
 
 	///
-    /// Provide access to the edges in the graph
+    /// Remove a vertex and its edges from the graph
+    /// The vertex leaves a tombstone, so the descriptors of the other vertices do not change
+    /// A removed vertex keeps its slot as an isolated vertex until compact: num_vertices and vertices(graph) still count it, so arrays indexed by vertex stay valid
+    /// Tombstones at the end of the vertex list are released at once, since no descriptor moves
+    /// Adding an edge to a removed vertex makes it a vertex of the graph again
+    /// The edges are removed with clear_vertex, so a directed graph takes O(V log d) time, and a BidirectionalGraph O(deg log d)
+    /// @param u - a vertex descriptor
     /// @param graph - a graph
-    /// @return an iterator range representing the edges in the graph
     ///
-	friend std::pair<edge_iterator, edge_iterator> edges (const Graph& graph) 
+	friend void remove_vertex (vertex_descriptor u, basic_graph& graph) 
 	{
-		edge_iterator b(&graph, 0);
-		edge_iterator e(&graph, graph.edgesize);
-		return std::make_pair(b, e);
+		if(u >= graph.g.size() || graph.is_tombstone(u))
+			return;
+		clear_vertex(u, graph);
+		if(graph.tombstones.size() < graph.g.size())
+			graph.tombstones.resize(graph.g.size(), false);
+		graph.tombstones[u] = true;
+		++graph.removed;
+		while(!graph.g.empty() && graph.tombstones[graph.g.size() - 1])
+		{
+			graph.g.pop_back();
+			if(bidirectional)
+				graph.in.pop_back();
+			graph.tombstones.pop_back();
+			--graph.removed;
+		}
+		assert(graph.valid());
 	}
 
-	// ---------
-	// num_edges
-	// ---------
+	// ----------
+	// is_removed
+	// ----------
 
 	///
-    /// Determine the number of edges in the graph
+    /// @param u - a vertex descriptor
     /// @param graph - a graph
-    /// @return the number of edges in the graph
+    /// @return true if u was removed with remove_vertex, and its slot has not been released yet
     ///
-	friend edges_size_type num_edges (const Graph& graph) 
+	friend bool is_removed (vertex_descriptor u, const basic_graph& graph) 
 	{
-		return graph.edgesize;
+		return graph.is_tombstone(u);
 	}
 
-	// ------------
-	// num_vertices
-	// ------------
+	// -------
+	// compact
+	// -------
 
 	///
-    /// Determine the number of vertices in the graph
+    /// Release the slots of the removed vertices, renumbering the other vertices in their order, and the memory of the removed vertices and edges
+    /// Each adjacency set is rebuilt with the allocator that select_on_container_copy_construction gives, which is a new Arena for an arena_allocator, in O(V + E) time
+    /// The old Arena, and every chunk of it, is released when the last adjacency set leaves it, unless another graph or allocator still shares it; the graph then has an Arena of its own
+    /// The old and the new adjacency sets are both held until compact returns
     /// @param graph - a graph
-    /// @return the number of vertices in the graph
+    /// @return the new descriptor of every old vertex, or std::numeric_limits<vertex_descriptor>::max() for a removed vertex
     ///
-	friend vertices_size_type num_vertices (const Graph& graph) 
+	friend std::vector<vertex_descriptor> compact (basic_graph& graph) 
 	{
-		return graph.g.size();
+		const vertex_descriptor null = std::numeric_limits<vertex_descriptor>::max();
+		std::vector<vertex_descriptor> renumber(graph.g.size());
+		vertex_descriptor n = 0;
+		for(vertex_descriptor v = 0; v != graph.g.size(); ++v)
+			renumber[v] = graph.is_tombstone(v) ? null : n++;
+
+		// renumber is increasing, so each row moves down into a slot that has already been read
+		// An allocator that propagates on move assignment, such as arena_allocator, moves every slot that receives a row to the new allocator
+		const allocator_type fresh = std::allocator_traits<allocator_type>::select_on_container_copy_construction(graph.allocator);
+		graph.hubs.clear();
+		for(vertex_descriptor v = 0; v != graph.g.size(); ++v)
+		{
+			if(renumber[v] == null)
+				continue;
+			adjacency_set adjacent(fresh);
+			reserve_adjacent(adjacent, graph.g[v].size());
+			for(vertex_descriptor w : graph.g[v])
+				adjacent.insert(adjacent.end(), renumber[w]);
+			if(adjacent.size() > adjacency_index<vertex_descriptor>::hub_degree)
+				graph.hubs.insert(std::make_pair(renumber[v], adjacency_index<vertex_descriptor>(adjacent.begin(), adjacent.end(), adjacent.size(), n)));
+			graph.g[renumber[v]] = std::move(adjacent);
+
+			if(bidirectional)
+			{
+				adjacency_set sources(fresh);
+				reserve_adjacent(sources, graph.in[v].size());
+				for(vertex_descriptor w : graph.in[v])
+					sources.insert(sources.end(), renumber[w]);
+				graph.in[renumber[v]] = std::move(sources);
+			}
+		}
+		graph.g.erase(graph.g.begin() + n, graph.g.end());
+		graph.g.shrink_to_fit();
+		if(bidirectional)
+		{
+			graph.in.erase(graph.in.begin() + n, graph.in.end());
+			graph.in.shrink_to_fit();
+		}
+		graph.allocator = fresh;
+		std::vector<bool>().swap(graph.tombstones);
+		graph.removed = 0;
+		assert(graph.valid());
+		return renumber;
 	}
 
-	// ------
-	// source
-	// ------
+	// -----------------
+	// adjacent_vertices
+	// -----------------
 
-    ///
-    /// Access the source vertex of an edge in a graph
-    /// @param edge - the edge descriptor representing the edge in the graph
+	///
+    /// Provide access to the adjacent vertices to the source vertex in the graph
+    /// For example, if an edge from vertex u to vertex v exists in the graph, the vertex v is an adjacent vertex.
+    /// @param source - a vertex descriptor for the source vertex
     /// @param graph - a graph
-    /// @return the vertex descriptor of the source vertex
+    /// @return an iterator range representing the vertices adjacent to the source vertex in the graph
     ///
-	friend vertex_descriptor source (edge_descriptor edge, const Graph& graph) 
+	friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor source, const basic_graph& graph) 
 	{
-		return edge.first;
+		adjacency_iterator b = graph.g[source].begin();
+		adjacency_iterator e = graph.g[source].end();
+		return std::make_pair(b, e);
 	}
 
-	// ------
-	// target
+	// ---------------------
+	// inv_adjacent_vertices
+	// ---------------------
+
+	///
+    /// Provide access to the vertices that a target vertex is adjacent to, in a bidirectional graph
+    /// For example, if an edge from vertex u to vertex v exists in the graph, u is an inverse adjacent vertex of v.
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a bidirectional graph
+    /// @return an iterator range representing the sources of the edges into the target vertex
+    ///
+	friend std::pair<inv_adjacency_iterator, inv_adjacency_iterator> inv_adjacent_vertices (vertex_descriptor target, const basic_graph& graph) 
+	{
+		static_assert(bidirectional, "inv_adjacent_vertices needs a bidirectional_edgesS graph");
+		return std::make_pair(graph.in[target].begin(), graph.in[target].end());
+	}
+
+	// --------
+	// in_edges
+	// --------
+
+	///
+    /// Provide access to the edges into a vertex, in a bidirectional graph
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a bidirectional graph
+    /// @return an iterator range representing the edges whose target is the target vertex
+    ///
+	friend std::pair<in_edge_iterator, in_edge_iterator> in_edges (vertex_descriptor target, const basic_graph& graph) 
+	{
+		static_assert(bidirectional, "in_edges needs a bidirectional_edgesS graph");
+		in_edge_iterator b(graph.in[target].begin(), target);
+		in_edge_iterator e(graph.in[target].end(), target);
+		return std::make_pair(b, e);
+	}
+
+	// ---------
+	// in_degree
+	// ---------
+
+	///
+    /// Determine the number of edges into a vertex, in a bidirectional graph, in O(1) time
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a bidirectional graph
+    /// @return the number of edges whose target is the target vertex
+    ///
+	friend degree_size_type in_degree (vertex_descriptor target, const basic_graph& graph) 
+	{
+		static_assert(bidirectional, "in_degree needs a bidirectional_edgesS graph");
+		return graph.in[target].size();
+	}
+
+	// ----
+	// edge
+	// ----
+
+	///
+    /// Find the edge between a source and target vertex to the graph
+    /// A low-degree source is searched in its adjacency set, and a high-degree source is looked up in its adjacency_index in O(1) expected time
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a graph
+    /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor for the edge is returned regardless if the edge is present in the graph. The bool value is true if the edge is present. Otherwise, the bool value is false. 
+    ///
+	friend std::pair<edge_descriptor, bool> edge (vertex_descriptor source, vertex_descriptor target, const basic_graph& graph) 
+	{
+		GRAPH_TRACE_COUNT(edge_lookups, 1);
+		if(source < graph.g.size())
+		{
+			const adjacency_set& adjacent = graph.g[source];
+			if(adjacent.size() <= adjacency_index<vertex_descriptor>::hub_degree)
+				return std::make_pair(std::make_pair(source, target), adjacent.find(target) != adjacent.end());
+			return std::make_pair(std::make_pair(source, target), graph.hubs.find(source)->second.contains(target));
+		}
+		return std::make_pair(std::make_pair(source, target), false);
+	}
+
+	// -----
+	// edges
+	// -----
+
+	///
+    /// Provide access to the edges in the graph
+    /// The prefix-sum edge offsets that the iterators jump with are built here, in O(V) time, and shared by the two iterators and their copies
+    /// @param graph - a graph
+    /// @return an iterator range representing the edges in the graph
+    ///
+	friend std::pair<edge_iterator, edge_iterator> edges (const basic_graph& graph) 
+	{
+		const std::shared_ptr<const std::vector<edges_size_type> > offsets = graph.edge_offsets();
+		edge_iterator b(&graph, 0, offsets);
+		edge_iterator e(&graph, graph.edgesize, offsets);
+		return std::make_pair(b, e);
+	}
+
+	// ---------
+	// num_edges
+	// ---------
+
+	///
+    /// Determine the number of edges in the graph
+    /// @param graph - a graph
+    /// @return the number of edges in the graph
+    ///
+	friend edges_size_type num_edges (const basic_graph& graph) 
+	{
+		return graph.edgesize;
+	}
+
+	// ------------
+	// num_vertices
+	// ------------
+
+	///
+    /// Determine the number of vertices in the graph
+    /// @param graph - a graph
+    /// @return the number of vertices in the graph
+    ///
+	friend vertices_size_type num_vertices (const basic_graph& graph) 
+	{
+		return graph.g.size();
+	}
+
+	// ------
+	// source
+	// ------
+
+    ///
+    /// Access the source vertex of an edge in a graph
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the source vertex
+    ///
+	friend vertex_descriptor source (edge_descriptor edge, const basic_graph& graph) 
+	{
+		return edge.first;
+	}
+
+	// ------
+	// target
 	// ------
 
     ///
@@ -458,7 +1025,7 @@ public:
     /// @param graph - a graph
     /// @return the vertex descriptor of the target vertex
     ///
-	friend vertex_descriptor target (edge_descriptor edge, const Graph& graph) 
+	friend vertex_descriptor target (edge_descriptor edge, const basic_graph& graph) 
 	{
 		return edge.second;
 	}
@@ -473,7 +1040,7 @@ public:
     /// @param graph - a graph
     /// @return the vertex descriptor of the nth vertex in the graph's vertex list
     ///
-	friend vertex_descriptor vertex (vertices_size_type index, const Graph& graph) 
+	friend vertex_descriptor vertex (vertices_size_type index, const basic_graph& graph) 
 	{
 		return index;
 	}
@@ -487,10 +1054,10 @@ public:
     /// @param graph - a graph
     /// @return an iterator range representing the vertices in the graph
     ///
-	friend std::pair<vertex_iterator, vertex_iterator> vertices (const Graph& graph) 
+	friend std::pair<vertex_iterator, vertex_iterator> vertices (const basic_graph& graph) 
 	{
-		vertex_iterator b = graph.vertices.begin();
-		vertex_iterator e = graph.vertices.end();
+		vertex_iterator b(0);
+		vertex_iterator e(static_cast<vertex_descriptor>(graph.g.size()));
 		return std::make_pair(b, e);
 	}
 
@@ -499,8 +1066,198 @@ private:
 	// data
 	// ----
 	edges_size_type edgesize;
-	std::vector<vertex_descriptor> vertices; // Vertex List
-	std::vector<std::set<vertex_descriptor> > g; // Adjacency List
+	allocator_type allocator; // Shared by the adjacency sets, so it outlives them
+	std::vector<adjacency_set> g; // Adjacency List
+	std::vector<adjacency_set> in; // Sources of the in-edges of each vertex, empty unless the graph is bidirectional
+	std::unordered_map<vertex_descriptor, adjacency_index<vertex_descriptor> > hubs; // Membership indexes of the high-degree vertices
+	std::vector<bool> tombstones; // Removed vertices, empty until the first remove_vertex; the vertices past its end are not removed
+	vertices_size_type removed; // Number of tombstones set
+
+	// ----------
+	// index_edge
+	// ----------
+
+	///
+	/// Record a new edge in the membership index of its source
+	/// The source gets an adjacency_index once its degree passes adjacency_index::hub_degree
+	/// @param source - the source vertex of the new edge, whose adjacency set already holds target
+	/// @param target - the target vertex of the new edge
+	///
+	void index_edge (vertex_descriptor source, vertex_descriptor target) 
+	{
+		const adjacency_set& adjacent = g[source];
+		if(adjacent.size() <= adjacency_index<vertex_descriptor>::hub_degree)
+			return;
+
+		typename std::unordered_map<vertex_descriptor, adjacency_index<vertex_descriptor> >::iterator p = hubs.find(source);
+		if(p == hubs.end())
+			hubs.insert(std::make_pair(source, adjacency_index<vertex_descriptor>(adjacent.begin(), adjacent.end(), adjacent.size(), g.size())));
+		else
+			p->second.insert(target, g.size());
+	}
+
+	// ----------
+	// erase_edge
+	// ----------
+
+	///
+	/// Remove an edge, and its entry in the membership index of its source
+	/// The source loses its adjacency_index once its degree falls to adjacency_index::hub_degree
+	/// @param source - the source vertex of the edge
+	/// @param target - the target vertex of the edge
+	/// @return true if the edge was present
+	///
+	bool erase_edge (vertex_descriptor source, vertex_descriptor target) 
+	{
+		if(source >= g.size() || g[source].erase(target) == 0)
+			return false;
+		--edgesize;
+		if(bidirectional)
+			in[target].erase(source);
+		if(g[source].size() + 1 > adjacency_index<vertex_descriptor>::hub_degree)
+		{
+			if(g[source].size() <= adjacency_index<vertex_descriptor>::hub_degree)
+				hubs.erase(source);
+			else
+				hubs.find(source)->second.erase(target);
+		}
+		return true;
+	}
+
+	// ------------
+	// is_tombstone
+	// ------------
+
+	///
+	/// @param v - a vertex descriptor
+	/// @return true if v is a removed vertex
+	///
+	bool is_tombstone (vertex_descriptor v) const 
+	{
+		return v < tombstones.size() && tombstones[v];
+	}
+
+	// ------
+	// revive
+	// ------
+
+	///
+	/// Make a removed vertex a vertex of the graph again
+	/// @param v - a vertex descriptor
+	///
+	void revive (vertex_descriptor v) 
+	{
+		if(is_tombstone(v))
+		{
+			tombstones[v] = false;
+			--removed;
+		}
+	}
+
+	// ------------
+	// edge_offsets
+	// ------------
+
+	///
+	/// Build the prefix-sum edge offsets used by the edge_iterator to jump to an edge index
+	/// offsets[v] is the index of the first edge whose source is v, and offsets[num_vertices] is the number of edges
+	/// Each call builds new offsets in O(V) time, so the Graph holds no state that its const readers write
+	/// @return the Graph's edge offsets
+	///
+	std::shared_ptr<const std::vector<edges_size_type> > edge_offsets () const 
+	{
+		std::shared_ptr<std::vector<edges_size_type> > offsets = std::make_shared<std::vector<edges_size_type> >();
+		offsets->reserve(g.size() + 1);
+		offsets->push_back(0);
+		for(const adjacency_set& adjacent : g)
+			offsets->push_back(offsets->back() + adjacent.size());
+		return offsets;
+	}
+
+	// ----
+	// grow
+	// ----
+
+	///
+	/// Add vertices with empty adjacency sets until the graph has at least n vertices
+	/// The vertex table grows geometrically, so adding vertices one at a time is amortized O(1)
+	/// @param n - the minimum number of vertices of the graph
+	///
+	void grow (vertices_size_type n) 
+	{
+		if(n <= g.size())
+			return;
+		if(n > g.capacity())
+		{
+			g.reserve(std::max(n, 2 * g.capacity()));
+			GRAPH_TRACE_COUNT(allocations, 1);
+		}
+		while(g.size() < n)
+			g.push_back(adjacency_set(allocator));
+		if(bidirectional)
+		{
+			in.reserve(g.capacity());
+			while(in.size() < n)
+				in.push_back(adjacency_set(allocator));
+		}
+	}
+
+	// -------------
+	// insert_sorted
+	// -------------
+
+	///
+	/// Add a sorted, unique edge list to the graph
+	/// @param ed - the edge list, sorted by source and target
+	/// @param n - the minimum number of vertices of the graph after the insertion
+	///
+	void insert_sorted (const std::vector<edge_descriptor>& ed, vertices_size_type n) 
+	{
+		GRAPH_TRACE_PHASE("build_from_edges");
+		for(const edge_descriptor& e : ed)
+			n = std::max(n, static_cast<vertices_size_type>(std::max(e.first, e.second)) + 1);
+		grow(n);
+		std::vector<edge_descriptor> reversed; // target, source of the new edges, for the in-edge sets
+
+		// Targets arrive in ascending order, so inserting before end() does not search the adjacency set
+		for(std::size_t i = 0; i != ed.size(); )
+		{
+			const vertex_descriptor source = ed[i].first;
+			std::size_t j = i;
+			while(j != ed.size() && ed[j].first == source)
+				++j;
+			adjacency_set& adjacent = g[source];
+			reserve_adjacent(adjacent, adjacent.size() + (j - i));
+			for(; i != j; ++i)
+			{
+				std::size_t size = adjacent.size();
+				adjacent.insert(adjacent.end(), ed[i].second);
+				if(adjacent.size() != size)
+				{
+					++edgesize;
+					index_edge(source, ed[i].second);
+					revive(source);
+					revive(ed[i].second);
+					if(bidirectional)
+						reversed.push_back(std::make_pair(ed[i].second, source));
+				}
+			}
+		}
+
+		// Sorted by target, the sources of each in-edge set arrive in ascending order too
+		std::sort(reversed.begin(), reversed.end());
+		for(std::size_t i = 0; i != reversed.size(); )
+		{
+			adjacency_set& sources = in[reversed[i].first];
+			std::size_t j = i;
+			while(j != reversed.size() && reversed[j].first == reversed[i].first)
+				++j;
+			reserve_adjacent(sources, sources.size() + (j - i));
+			for(; i != j; ++i)
+				sources.insert(sources.end(), reversed[i].second);
+		}
+		assert(valid());
+	}
 
 	// -----
 	// valid
@@ -511,7 +1268,7 @@ private:
 	///
 	bool valid () const 
 	{
-		return (edgesize == 0 && vertices.size() == 0 && g.size() == 0) || (edgesize >= 0 && vertices.size() == g.size() && vertices.size() > 0 && g.size() > 0);
+		return (edgesize == 0 || g.size() > 0) && removed <= tombstones.size() && tombstones.size() <= g.size() && in.size() == (bidirectional ? g.size() : 0);
 	}
 
 public:
@@ -520,19 +1277,197 @@ public:
 	// ------------
 
     ///
-	/// Default Constructor - Empty Graph
+	/// Default Constructor - Empty Graph, with a new Arena of its own for the default allocator
+	///
+	basic_graph () : edgesize(0), removed(0)
+	{
+		assert(valid());
+	}
+
+	///
+	/// Allocator Constructor - Empty Graph whose adjacency sets allocate with a copy of an allocator
+	/// Graphs built with copies of one arena_allocator share its Arena
+	/// @param a - an allocator
+	///
+	explicit basic_graph (const allocator_type& a) : edgesize(0), allocator(a), removed(0)
+	{
+		assert(valid());
+	}
+
+	///
+	/// Range Constructor - Graph built from a list of edges with build_from_edges
+	/// Duplicate edges are ignored
+	/// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+	/// @param b - the beginning of the edge list
+	/// @param e - the end of the edge list
+	/// @param n - the minimum number of vertices of the graph
+	///
+	template <typename II>
+	basic_graph (II b, II e, vertices_size_type n = 0) : edgesize(0), removed(0)
+	{
+		build_from_edges(b, e, n, *this);
+	}
+
+	///
+	/// Range Constructor - Graph built from a list of edges with build_from_edges, sorting the edge list with every thread of the pool
+	/// @tparam II - Input Iterator Template, whose value_type is a std::pair of vertex descriptors
+	/// @param b - the beginning of the edge list
+	/// @param e - the end of the edge list
+	/// @param n - the minimum number of vertices of the graph
+	/// @param pool - the threads that sort the edge list
+	///
+	template <typename II>
+	basic_graph (II b, II e, vertices_size_type n, ThreadPool& pool) : edgesize(0), removed(0)
+	{
+		build_from_edges(b, e, n, *this, pool);
+	}
+
+	///
+	/// Copy Constructor - the adjacency sets are copied into the allocator given by select_on_container_copy_construction, which is a new Arena for an arena_allocator
+	/// @param that - a graph
+	///
+	basic_graph (const basic_graph& that) : edgesize(that.edgesize), allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(that.allocator)), hubs(that.hubs), tombstones(that.tombstones), removed(that.removed)
+	{
+		g.reserve(that.g.size());
+		for(const adjacency_set& adjacent : that.g)
+			g.push_back(adjacency_set(adjacent, allocator));
+		in.reserve(that.in.size());
+		for(const adjacency_set& sources : that.in)
+			in.push_back(adjacency_set(sources, allocator));
+		assert(valid());
+	}
+
+	///
+	/// Move Constructor - the adjacency sets keep their allocator, and that graph is left empty
+	/// @param that - a graph
 	///
-	Graph () : edgesize(0)
+	basic_graph (basic_graph&& that) : edgesize(that.edgesize), allocator(that.allocator), g(std::move(that.g)), in(std::move(that.in)), hubs(std::move(that.hubs)), tombstones(std::move(that.tombstones)), removed(that.removed)
 	{
+		that.edgesize = 0;
+		that.g.clear();
+		that.in.clear();
+		that.hubs.clear();
+		that.tombstones.clear();
+		that.removed = 0;
 		assert(valid());
 	}
 
-	// Default copy, destructor, and copy assignment
-	// Graph  (const Graph<T>&);
-	// ~Graph ();
-	// Graph& operator = (const Graph&);
+	// Default destructor
+
+	// ----------
+	// operator =
+	// ----------
+
+	///
+	/// Copy and Move Assignment
+	/// @param that - a graph, copied or moved into the parameter
+	/// @return this graph, which takes the contents and the allocator of that
+	///
+	basic_graph& operator = (basic_graph that)
+	{
+		std::swap(edgesize, that.edgesize);
+		std::swap(allocator, that.allocator);
+		g.swap(that.g);
+		in.swap(that.in);
+		hubs.swap(that.hubs);
+		tombstones.swap(that.tombstones);
+		std::swap(removed, that.removed);
+		assert(valid());
+		return *this;
+	}
 };
 
+template <typename V, typename S, typename A, typename D>
+const bool basic_graph<V, S, A, D>::bidirectional;
+
+// -----
+// Graph
+// -----
+
+///
+/// The directed graph with std::size_t vertex descriptors, std::set adjacency, and the default arena_allocator
+///
+typedef basic_graph<> Graph;
+
+///
+/// The directed graph that also stores in-edges, like boost::adjacency_list<boost::setS, boost::vecS, boost::bidirectionalS>
+///
+typedef basic_graph<std::size_t, ordered_setS, arena_allocator<std::size_t>, bidirectional_edgesS> BidirectionalGraph;
+
+// -----------
+// find_cycle
+// -----------
+
+///
+/// A helper function for the has_cycle functions
+/// This function executes a single iterative depth-first search over every vertex of the graph
+/// A white vertex is unexplored, a gray vertex is on the current search path, and a black vertex is finished
+/// An edge to a gray vertex closes a cycle, which is made of the search path from that vertex to the current vertex
+/// The colors and the search path are allocated once, so the search runs in O(V + E) time
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param cycle - if not null, receives the vertices of the first cycle found, in path order
+/// @return true if the graph contains a cycle; Otherwise, false
+///
+template <typename G>
+bool find_cycle (const G& graph, std::vector<typename G::vertex_descriptor>* cycle) 
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	enum {white, gray, black};
+	GRAPH_TRACE_PHASE("has_cycle");
+
+	std::vector<char> colors(num_vertices(graph), white);
+	std::vector<std::pair<vertex_descriptor, std::pair<adjacency_iterator, adjacency_iterator> > > path;
+	std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
+	while(v.first != v.second)
+	{
+		if(colors[*v.first] == white)
+		{
+			colors[*v.first] = gray;
+			path.push_back(std::make_pair(*v.first, adjacent_vertices(*v.first, graph)));
+			GRAPH_TRACE_COUNT(vertices_visited, 1);
+			GRAPH_TRACE_DEPTH(1);
+		}
+
+		while(!path.empty())
+		{
+			std::pair<adjacency_iterator, adjacency_iterator>& av = path.back().second;
+			if(av.first == av.second)
+			{
+				colors[path.back().first] = black;
+				path.pop_back();
+				continue;
+			}
+
+			vertex_descriptor w = *av.first;
+			++av.first;
+			GRAPH_TRACE_COUNT(edges_scanned, 1);
+			if(colors[w] == gray)
+			{
+				if(cycle != nullptr)
+				{
+					std::size_t i = path.size() - 1;
+					while(path[i].first != w)
+						--i;
+					for(; i < path.size(); ++i)
+						cycle->push_back(path[i].first);
+				}
+				return true;
+			}
+			else if(colors[w] == white)
+			{
+				colors[w] = gray;
+				path.push_back(std::make_pair(w, adjacent_vertices(w, graph)));
+				GRAPH_TRACE_COUNT(vertices_visited, 1);
+				GRAPH_TRACE_DEPTH(path.size());
+			}
+		}
+		++v.first;
+	}
+	return false;
+}
+
 // ---------
 // has_cycle
 // ---------
@@ -549,29 +1484,118 @@ public:
 template <typename G>
 bool has_cycle (const G& graph) 
 {
+	return find_cycle(graph, static_cast<std::vector<typename G::vertex_descriptor>*>(nullptr));
+}
+
+///
+/// Determine whether the graph contains a cycle and report the first cycle found
+/// The vertices of the cycle are written in path order: each vertex has an edge to the next one, and the last vertex has an edge to the first one
+/// depth-first traversal
+/// three colors
+/// @tparam G - Graph Class Template
+/// @tparam OI - Output Iterator Template
+/// @param graph - a graph
+/// @param x - an output iterator, which receives the vertices of the cycle
+/// @return true if the graph contains a cycle; Otherwise, false
+///
+template <typename G, typename OI>
+bool has_cycle (const G& graph, OI x) 
+{
+	std::vector<typename G::vertex_descriptor> cycle;
+	if(!find_cycle(graph, &cycle))
+		return false;
+	std::copy(cycle.begin(), cycle.end(), x);
+	return true;
+}
+
+// -----------------
+// topological_visit
+// -----------------
+
+///
+/// depth-first traversal
+/// three colors
+/// Visit the vertices of the directed, acyclic graph in reverse topological order: every vertex is visited after all of the vertices it has an edge to
+/// This is the search of topological_sort, for the algorithms that work on each vertex as it finishes instead of storing the order
+/// The search uses an explicit stack, so its depth is not limited by the thread's stack size
+/// The search starts from the vertices in ascending order, and visits the adjacent vertices of each vertex in ascending order
+/// An edge to a vertex on the current search path is a back edge, which proves the graph has a cycle
+/// The colors, the search path, and the sorted adjacent vertices are allocated once, so the search runs in O(V + E log(max degree)) time, or O(V + E) when the adjacent vertices are already sorted
+/// @tparam G - Graph Class Template
+/// @tparam F - Function Template, called as finish(v) for each vertex
+/// @param graph - graph
+/// @param finish - the function that visits each vertex
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename F>
+void topological_visit (const G& graph, F finish) 
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	enum {white, gray, black};
+
+	GRAPH_TRACE_PHASE("topological_sort");
+
+	// Each search path entry holds a vertex and the range of its unexplored adjacent vertices in pending
+	std::vector<char> colors(num_vertices(graph), white);
+	std::vector<std::pair<vertex_descriptor, std::pair<std::size_t, std::size_t> > > path;
+	std::vector<vertex_descriptor> pending;
+	path.reserve(num_vertices(graph));
+	pending.reserve(num_edges(graph));
+
 	std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
 	while(v.first != v.second)
 	{
-		std::vector<bool> explored(num_vertices(graph));
-		std::stack<typename G::vertex_descriptor> vlist;
-		vlist.push(*v.first);
-		while(!vlist.empty())
+		vertex_descriptor u = *v.first;
+		++v.first;
+		if(colors[u] != white)
+			continue;
+
+		while(true)
 		{
-			std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(vlist.top(), graph);
-			explored[vlist.top()] = true;
-			vlist.pop();
-			while(av.first != av.second)
+			// Discover u: gray it and queue its adjacent vertices in ascending order
+			colors[u] = gray;
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+			std::size_t b = pending.size();
+			pending.insert(pending.end(), av.first, av.second);
+			if(!std::is_sorted(pending.begin() + b, pending.end()))
+				std::sort(pending.begin() + b, pending.end());
+			path.push_back(std::make_pair(u, std::make_pair(b, pending.size())));
+			GRAPH_TRACE_COUNT(vertices_visited, 1);
+			GRAPH_TRACE_COUNT(edges_scanned, pending.size() - b);
+			GRAPH_TRACE_DEPTH(path.size());
+
+			// Finish vertices until one has an unexplored adjacent vertex
+			bool discovered = false;
+			while(!path.empty() && !discovered)
 			{
-				if(!explored[*av.first])
-					vlist.push(*av.first);
-				if(*v.first == *av.first)
-					return true;
-				++av.first;
+				std::pair<std::size_t, std::size_t>& range = path.back().second;
+				while(range.first != range.second && !discovered)
+				{
+					vertex_descriptor w = pending[range.first];
+					++range.first;
+					if(colors[w] == gray)
+						boost::throw_exception(boost::not_a_dag());
+					if(colors[w] == white)
+					{
+						u = w;
+						discovered = true;
+					}
+				}
+
+				if(!discovered)
+				{
+					colors[path.back().first] = black;
+					finish(path.back().first);
+					path.pop_back();
+					pending.resize(path.empty() ? 0 : path.back().second.second);
+				}
 			}
+
+			if(!discovered)
+				break;
 		}
-		++v.first;
 	}
-	return false;
 }
 
 // ----------------
@@ -580,65 +1604,219 @@ bool has_cycle (const G& graph)
 
 ///
 /// depth-first traversal
-/// two colors
+/// three colors
 /// Generate a topological sort for the directed, acyclic graph
+/// The vertices are written in reverse topological order: every vertex is written after all of the vertices it has an edge to
+/// The vertices are written in the order that topological_visit visits them, in O(V + E) time when the adjacent vertices are already sorted
 /// @tparam G - Graph Class Template
 /// @tparam OI - Output Iterator Template
 /// @param graph - graph
 /// @param x - an output iterator
-/// @throws Boost's not_a_dag exception if has_cycle()
+/// @throws Boost's not_a_dag exception if the graph has a cycle
 ///
 template <typename G, typename OI>
 void topological_sort (const G& graph, OI x) 
 {
-	if(has_cycle(graph))
-		boost::throw_exception(boost::not_a_dag());
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	topological_visit(graph, [&] (vertex_descriptor v)
+	{
+		*x = v;
+		++x;
+	});
+}
 
-	std::vector<bool> visited(num_vertices(graph) + 1);
-	std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
-	while(v.first != v.second)
+// -------------------
+// transpose_adjacency
+// -------------------
+
+///
+/// Build the sources of the in-edges of every vertex in compressed sparse row form, with every thread of the pool
+/// The sources of the in-edges of vertex v are sources[offsets[v]] through sources[offsets[v + 1] - 1], in no particular order
+/// This is for the searches that walk edges backward over a graph that does not store its in-edges, at the cost of one vertex descriptor per edge
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param offsets - receives the num_vertices(graph) + 1 row offsets
+/// @param sources - receives the sources of the in-edges
+/// @param pool - the threads that read the edges
+///
+template <typename G>
+void transpose_adjacency (const G& graph, std::vector<std::size_t>& offsets, std::vector<typename G::vertex_descriptor>& sources, ThreadPool& pool) 
+{
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	const std::size_t n = num_vertices(graph);
+	std::vector<std::atomic<std::size_t> > cursor(n);
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
 	{
-		if(!visited[*v.first])
-			depth_search(graph, x, *v.first, visited);
-		++v.first;
+		for(std::size_t i = b; i < e; ++i)
+			cursor[i].store(0, std::memory_order_relaxed);
+	});
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			for(; av.first != av.second; ++av.first)
+				cursor[*av.first].fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	offsets.assign(n + 1, 0);
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		offsets[i + 1] = offsets[i] + cursor[i].load(std::memory_order_relaxed);
+		cursor[i].store(offsets[i], std::memory_order_relaxed);
 	}
+	sources.resize(offsets[n]);
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			for(; av.first != av.second; ++av.first)
+				sources[cursor[*av.first].fetch_add(1, std::memory_order_relaxed)] = vertex(i, graph);
+		}
+	});
 }
 
+// ------------------
+// topological_levels
+// ------------------
+
 ///
-/// A helper function for the topological sort function
-/// This function executes a depth-first search of the graph
-/// The function recursively executes, following the requirement vertices for the current vertex
-/// The function processes the vertices in ascending order of their vertex number
+/// breadth-first traversal (Kahn's algorithm)
+/// Partition the vertices of the directed, acyclic graph into levels
+/// Level 0 holds the vertices without incoming edges, and level d + 1 holds the vertices whose incoming edges all come from levels 0 through d
+/// The vertices of one level do not depend on each other, so they can be processed concurrently
+/// The in-degrees are counted in parallel, and each level is expanded in parallel with atomic in-degree decrements
+/// Each level is sorted in ascending order, so the result does not depend on the thread schedule
 /// @tparam G - Graph Class Template
-/// @tparam OI - Output Iterator Template
 /// @param graph - graph
-/// @param x - an output iterator
-/// @param v -  the vertex descriptor representing the current vertex
-/// @param visited - a std::vector marking which vertices of the graph are visited by the depth first-search
+/// @param pool - the threads that run the traversal
+/// @return the levels of the graph, in topological order
+/// @throws Boost's not_a_dag exception if the graph has a cycle
 ///
-template <typename G, typename OI>
-void depth_search (const G& graph, OI x, const typename G::vertex_descriptor& v, std::vector<bool>& visited) 
+template <typename G>
+std::vector<std::vector<typename G::vertex_descriptor> > topological_levels (const G& graph, ThreadPool& pool) 
 {
-	std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(v, graph);
-	std::priority_queue< typename G::vertex_descriptor, std::vector<typename G::vertex_descriptor>, std::greater<typename G::vertex_descriptor> > min_heap;
-	while(av.first != av.second)
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	GRAPH_TRACE_PHASE("topological_levels");
+	const std::size_t n = num_vertices(graph);
+	std::vector<std::atomic<std::size_t> > indegree(n);
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
 	{
-		if(!visited[*av.first])
-			min_heap.push(*av.first);
-		++av.first;
-	}
+		for(std::size_t i = b; i < e; ++i)
+			indegree[i].store(0, std::memory_order_relaxed);
+	});
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			for(; av.first != av.second; ++av.first)
+				indegree[*av.first].fetch_add(1, std::memory_order_relaxed);
+		}
+	});
 
-	while(!min_heap.empty())
+	// Each chunk gathers its vertices locally and appends them to the level once
+	std::vector<std::vector<vertex_descriptor> > levels;
+	std::vector<vertex_descriptor> level;
+	std::mutex guard;
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
 	{
-		if(!visited[min_heap.top()])
+		std::vector<vertex_descriptor> found;
+		for(std::size_t i = b; i < e; ++i)
 		{
-			depth_search(graph, x, min_heap.top(), visited);
+			if(indegree[i].load(std::memory_order_relaxed) == 0)
+				found.push_back(vertex(i, graph));
 		}
-		min_heap.pop();
+		std::lock_guard<std::mutex> locked(guard);
+		level.insert(level.end(), found.begin(), found.end());
+	});
+
+	std::size_t finished = 0;
+	while(!level.empty())
+	{
+		parallel_sort(pool, level.begin(), level.end());
+		finished += level.size();
+		levels.push_back(std::vector<vertex_descriptor>());
+		levels.back().swap(level);
+
+		const std::vector<vertex_descriptor>& frontier = levels.back();
+		pool.parallel_for(0, frontier.size(), [&] (std::size_t b, std::size_t e)
+		{
+			std::vector<vertex_descriptor> found;
+			for(std::size_t i = b; i < e; ++i)
+			{
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(frontier[i], graph);
+				for(; av.first != av.second; ++av.first)
+				{
+					if(indegree[*av.first].fetch_sub(1, std::memory_order_acq_rel) == 1)
+						found.push_back(*av.first);
+				}
+			}
+			std::lock_guard<std::mutex> locked(guard);
+			level.insert(level.end(), found.begin(), found.end());
+		});
 	}
-	visited[v] = true;
-	*x = v;
-	++x;
+
+	// The vertices on a cycle never reach an in-degree of 0
+	if(finished != n)
+		boost::throw_exception(boost::not_a_dag());
+	return levels;
+}
+
+///
+/// Partition the vertices of the directed, acyclic graph into levels, with one thread per hardware thread
+/// @tparam G - Graph Class Template
+/// @param graph - graph
+/// @return the levels of the graph, in topological order
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G>
+std::vector<std::vector<typename G::vertex_descriptor> > topological_levels (const G& graph) 
+{
+	ThreadPool pool;
+	return topological_levels(graph, pool);
+}
+
+// -------------------------
+// parallel_topological_sort
+// -------------------------
+
+///
+/// Generate a topological sort for the directed, acyclic graph from its topological levels
+/// Like topological_sort, the vertices are written in reverse topological order: the last level first, each level in ascending order
+/// @tparam G - Graph Class Template
+/// @tparam OI - Output Iterator Template
+/// @param graph - graph
+/// @param x - an output iterator
+/// @param pool - the threads that run the traversal
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename OI>
+void parallel_topological_sort (const G& graph, OI x, ThreadPool& pool) 
+{
+	std::vector<std::vector<typename G::vertex_descriptor> > levels = topological_levels(graph, pool);
+	for(std::size_t d = levels.size(); d != 0; --d)
+		x = std::copy(levels[d - 1].begin(), levels[d - 1].end(), x);
+}
+
+///
+/// Generate a topological sort for the directed, acyclic graph, with one thread per hardware thread
+/// @tparam G - Graph Class Template
+/// @tparam OI - Output Iterator Template
+/// @param graph - graph
+/// @param x - an output iterator
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename OI>
+void parallel_topological_sort (const G& graph, OI x) 
+{
+	ThreadPool pool;
+	parallel_topological_sort(graph, x, pool);
 }
 
 #endif // Graph_h
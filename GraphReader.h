@@ -0,0 +1,537 @@
+// ----------------------------
+// projects/graph/GraphReader.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef GraphReader_h
+#define GraphReader_h
+
+// --------
+// includes
+// --------
+#include <fcntl.h> // open
+#include <sys/mman.h> // madvise, mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstring> // memchr, memmove
+#include <algorithm> // max, min
+#include <functional> // function
+#include <istream> // istream
+#include <limits> // numeric_limits
+#include <mutex> // mutex, lock_guard
+#include <stdexcept> // runtime_error
+#include <string> // string, to_string
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "ThreadPool.h" // ThreadPool
+
+
+// ----------------
+// edge_list_format
+// ----------------
+
+///
+/// The text formats read by the edge list readers
+/// pairs: one "source target" pair per line, separated by spaces or tabs; lines starting with # or % are comments
+/// snap: the Stanford SNAP format, which is the pairs format with # comments and tab separators
+/// dimacs: "p <problem> <vertices> <edges>" once, then "a source target [weight]" or "e source target" lines with 1-based vertices; lines starting with c are comments
+/// Columns after the target, such as weights, are ignored
+///
+enum edge_list_format
+{
+	edge_list_pairs,
+	edge_list_snap,
+	edge_list_dimacs
+};
+
+// ----------------
+// edge_list_parser
+// ----------------
+
+///
+/// A tokenizer for the edge list formats that parses in place from a character buffer
+/// The parser never copies a line: it walks the buffer with a pointer and converts the numbers as it goes
+///
+class edge_list_parser
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::uint64_t vertex_descriptor;
+	typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor; // source, target
+
+private:
+	// ----
+	// data
+	// ----
+	edge_list_format format;
+	std::uint64_t vertices; // the vertex count declared by a DIMACS problem line, or 0
+
+	// ----
+	// fail
+	// ----
+
+	///
+	/// Report a line that does not belong to the format
+	/// @param offset - the position of the line in the input
+	/// @throws std::runtime_error always
+	///
+	static void fail (std::size_t offset)
+	{
+		throw std::runtime_error("malformed edge list line at byte " + std::to_string(offset));
+	}
+
+	// ------
+	// number
+	// ------
+
+	///
+	/// Parse an unsigned decimal number after optional spaces and tabs
+	/// @param p - the position to parse from, which is moved past the number
+	/// @param e - the end of the line
+	/// @param n - receives the number
+	/// @return true if a number was found, and it fits in 64 bits
+	///
+	static bool number (const char*& p, const char* e, std::uint64_t& n)
+	{
+		while(p != e && (*p == ' ' || *p == '\t'))
+			++p;
+		if(p == e || *p < '0' || *p > '9')
+			return false;
+		n = 0;
+		while(p != e && *p >= '0' && *p <= '9')
+		{
+			const std::uint64_t digit = *p - '0';
+			if(n > (std::numeric_limits<std::uint64_t>::max() - digit) / 10)
+				return false;
+			n = 10 * n + digit;
+			++p;
+		}
+		return true;
+	}
+
+	// ----
+	// line
+	// ----
+
+	///
+	/// Parse one line, without its line terminator
+	/// @param b - the beginning of the line
+	/// @param e - the end of the line
+	/// @param offset - the position of the line in the input, for error messages
+	/// @param edges - receives the edge of the line, if it has one
+	///
+	void line (const char* b, const char* e, std::size_t offset, std::vector<edge_descriptor>& edges)
+	{
+		while(b != e && (*b == ' ' || *b == '\t' || *b == '\r'))
+			++b;
+		while(e != b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r'))
+			--e;
+		if(b == e)
+			return;
+
+		std::uint64_t u;
+		std::uint64_t v;
+		if(format != edge_list_dimacs)
+		{
+			if(*b == '#' || *b == '%')
+				return;
+			if(!number(b, e, u) || !number(b, e, v))
+				fail(offset);
+			edges.push_back(std::make_pair(u, v));
+			return;
+		}
+
+		const char kind = *b++;
+		if(kind == 'c')
+			return;
+		if(kind == 'p')
+		{
+			// Skip the problem name, then read the vertex count
+			while(b != e && (*b == ' ' || *b == '\t'))
+				++b;
+			while(b != e && *b != ' ' && *b != '\t')
+				++b;
+			if(!number(b, e, vertices))
+				fail(offset);
+			return;
+		}
+		if((kind != 'a' && kind != 'e') || !number(b, e, u) || !number(b, e, v) || u == 0 || v == 0)
+			fail(offset);
+		edges.push_back(std::make_pair(u - 1, v - 1));
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// @param f - the format of the input
+	///
+	explicit edge_list_parser (edge_list_format f) : format(f), vertices(0)
+	{}
+
+	// -----
+	// parse
+	// -----
+
+	///
+	/// Parse the lines in [b, e) and pass their edges to f in batches
+	/// The last line does not need a line terminator
+	/// @tparam F - Function Template, called as f(const std::vector<edge_descriptor>&) for each batch
+	/// @param b - the beginning of the buffer
+	/// @param e - the end of the buffer
+	/// @param offset - the position of b in the input, for error messages
+	/// @param edges - the current batch, which may hold edges from earlier buffers
+	/// @param batch - the number of edges that fills a batch
+	/// @param f - the consumer of the batches
+	///
+	template <typename F>
+	void parse (const char* b, const char* e, std::size_t offset, std::vector<edge_descriptor>& edges, std::size_t batch, F& f)
+	{
+		const char* p = b;
+		while(p != e)
+		{
+			const char* n = static_cast<const char*>(std::memchr(p, '\n', e - p));
+			if(n == nullptr)
+				n = e;
+			line(p, n, offset + (p - b), edges);
+			if(edges.size() >= batch)
+			{
+				f(static_cast<const std::vector<edge_descriptor>&>(edges));
+				edges.clear();
+			}
+			p = (n == e) ? e : n + 1;
+		}
+	}
+
+	// -----------------
+	// num_vertices_hint
+	// -----------------
+
+	///
+	/// @return the vertex count declared by a DIMACS problem line, or 0 if there was none
+	///
+	std::uint64_t num_vertices_hint () const
+	{
+		return vertices;
+	}
+};
+
+// ----------
+// MappedFile
+// ----------
+
+///
+/// A whole file mapped read-only into memory
+///
+class MappedFile
+{
+private:
+	// ----
+	// data
+	// ----
+	const char* base;
+	std::size_t length;
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Map a file read-only for a sequential scan
+	/// @param path - the path of the file
+	/// @throws std::runtime_error if the file cannot be opened or mapped
+	///
+	explicit MappedFile (const std::string& path) : base(nullptr), length(0)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		struct stat st;
+		if(fd < 0 || fstat(fd, &st) != 0)
+		{
+			if(fd >= 0)
+				close(fd);
+			throw std::runtime_error("cannot open " + path);
+		}
+		length = st.st_size;
+		if(length != 0)
+		{
+			void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(p == MAP_FAILED)
+			{
+				close(fd);
+				throw std::runtime_error("cannot map " + path);
+			}
+			madvise(p, length, MADV_SEQUENTIAL);
+			base = static_cast<const char*>(p);
+		}
+		close(fd);
+	}
+
+	///
+	/// Destructor - unmaps the file
+	///
+	~MappedFile ()
+	{
+		if(base != nullptr)
+			munmap(const_cast<char*>(base), length);
+	}
+
+	MappedFile (const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	// -----
+	// begin
+	// -----
+
+	///
+	/// @return the first character of the file
+	///
+	const char* begin () const
+	{
+		return base;
+	}
+
+	// ---
+	// end
+	// ---
+
+	///
+	/// @return one past the last character of the file
+	///
+	const char* end () const
+	{
+		return base + length;
+	}
+};
+
+// --------------
+// read_edge_list
+// --------------
+
+const std::size_t edge_list_batch = 1 << 20; // edges per batch
+const std::size_t edge_list_chunk = 1 << 22; // bytes per chunk
+
+///
+/// Read an edge list from a stream in large chunks, and pass its edges to f in batches
+/// @tparam F - Function Template, called as f(const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) for each batch
+/// @param in - the input stream
+/// @param format - the format of the input
+/// @param f - the consumer of the batches
+/// @param batch - the number of edges that fills a batch
+/// @return the vertex count declared by the input, or 0 if there was none
+/// @throws std::runtime_error if a line does not belong to the format
+///
+template <typename F>
+std::uint64_t read_edge_list (std::istream& in, edge_list_format format, F f, std::size_t batch = edge_list_batch)
+{
+	edge_list_parser parser(format);
+	std::vector<edge_list_parser::edge_descriptor> edges;
+	std::vector<char> buffer(edge_list_chunk);
+	std::size_t kept = 0; // the length of the incomplete line at the front of the buffer
+	std::size_t offset = 0;
+	while(in)
+	{
+		in.read(buffer.data() + kept, buffer.size() - kept);
+		std::size_t size = kept + in.gcount();
+		const char* b = buffer.data();
+		const char* e = b + size;
+		if(in)
+		{
+			// Parse the complete lines only, and keep the rest for the next chunk
+			const char* p = e;
+			while(p != b && p[-1] != '\n')
+				--p;
+			if(p == b)
+			{
+				// A line longer than the buffer: grow the buffer
+				kept = size;
+				buffer.resize(2 * buffer.size());
+				continue;
+			}
+			e = p;
+		}
+		parser.parse(b, e, offset, edges, batch, f);
+		offset += e - b;
+		kept = size - (e - b);
+		std::memmove(buffer.data(), e, kept);
+	}
+	if(!edges.empty())
+		f(static_cast<const std::vector<edge_list_parser::edge_descriptor>&>(edges));
+	return parser.num_vertices_hint();
+}
+
+///
+/// Read an edge list file through a read-only mapping, and pass its edges to f in batches
+/// @tparam F - Function Template, called as f(const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) for each batch
+/// @param path - the path of the file
+/// @param format - the format of the input
+/// @param f - the consumer of the batches
+/// @param batch - the number of edges that fills a batch
+/// @return the vertex count declared by the input, or 0 if there was none
+/// @throws std::runtime_error if the file cannot be mapped or a line does not belong to the format
+///
+template <typename F>
+std::uint64_t read_edge_list (const std::string& path, edge_list_format format, F f, std::size_t batch = edge_list_batch)
+{
+	MappedFile file(path);
+	edge_list_parser parser(format);
+	std::vector<edge_list_parser::edge_descriptor> edges;
+	parser.parse(file.begin(), file.end(), 0, edges, batch, f);
+	if(!edges.empty())
+		f(static_cast<const std::vector<edge_list_parser::edge_descriptor>&>(edges));
+	return parser.num_vertices_hint();
+}
+
+///
+/// Read an edge list file through a read-only mapping, parsing one chunk per thread of the pool
+/// The chunks are split at line boundaries, and f is called for one batch at a time, in no particular order
+/// f runs on the pool's threads, so it must not start a loop on the same pool
+/// @tparam F - Function Template, called as f(const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) for each batch
+/// @param path - the path of the file
+/// @param format - the format of the input
+/// @param f - the consumer of the batches
+/// @param pool - the threads that parse the file
+/// @param batch - the number of edges that fills a batch
+/// @return the vertex count declared by the input, or 0 if there was none
+/// @throws std::runtime_error if the file cannot be mapped or a line does not belong to the format
+///
+template <typename F>
+std::uint64_t read_edge_list (const std::string& path, edge_list_format format, F f, ThreadPool& pool, std::size_t batch = edge_list_batch)
+{
+	MappedFile file(path);
+	const char* b = file.begin();
+	const std::size_t size = file.end() - b;
+	const std::size_t chunks = std::max<std::size_t>(1, std::min(4 * pool.size(), size / edge_list_chunk));
+
+	// Move each chunk boundary forward to the start of the next line
+	std::vector<std::size_t> bounds(chunks + 1, size);
+	bounds[0] = 0;
+	for(std::size_t i = 1; i < chunks; ++i)
+	{
+		std::size_t p = std::max(bounds[i - 1], size * i / chunks);
+		while(p < size && b[p - 1] != '\n')
+			++p;
+		bounds[i] = p;
+	}
+
+	std::mutex guard;
+	std::uint64_t vertices = 0;
+	std::function<void (const std::vector<edge_list_parser::edge_descriptor>&)> consume = [&] (const std::vector<edge_list_parser::edge_descriptor>& edges)
+	{
+		std::lock_guard<std::mutex> locked(guard);
+		f(edges);
+	};
+	pool.parallel_for(0, chunks, [&] (std::size_t first, std::size_t last)
+	{
+		for(std::size_t i = first; i < last; ++i)
+		{
+			edge_list_parser parser(format);
+			std::vector<edge_list_parser::edge_descriptor> edges;
+			parser.parse(b + bounds[i], b + bounds[i + 1], bounds[i], edges, batch, consume);
+			if(!edges.empty())
+				consume(edges);
+			std::lock_guard<std::mutex> locked(guard);
+			vertices = std::max(vertices, parser.num_vertices_hint());
+		}
+	}, 1);
+	return vertices;
+}
+
+// ---------------
+// check_vertex_id
+// ---------------
+
+///
+/// A helper function for load_edge_list
+/// The parser reads 64-bit vertices, which build_from_edges narrows to the vertex_descriptor of the graph
+/// @tparam G - Graph Class Template
+/// @param v - a vertex read from an edge list
+/// @throws std::runtime_error if v is larger than std::numeric_limits<typename G::vertex_descriptor>::max()
+///
+template <typename G>
+void check_vertex_id (std::uint64_t v)
+{
+	if(v > static_cast<std::uint64_t>(std::numeric_limits<typename G::vertex_descriptor>::max()))
+		throw std::runtime_error("edge list vertex " + std::to_string(v) + " does not fit the graph's vertex_descriptor");
+}
+
+///
+/// A helper function for load_edge_list
+/// @tparam G - Graph Class Template
+/// @param edges - a batch of edges read from an edge list
+/// @throws std::runtime_error if a vertex of the batch does not fit the vertex_descriptor of the graph
+///
+template <typename G>
+void check_vertex_ids (const std::vector<edge_list_parser::edge_descriptor>& edges)
+{
+	for(const edge_list_parser::edge_descriptor& e : edges)
+	{
+		check_vertex_id<G>(e.first);
+		check_vertex_id<G>(e.second);
+	}
+}
+
+// --------------
+// load_edge_list
+// --------------
+
+///
+/// Add the edges of an edge list file to a graph, one batch at a time with build_from_edges
+/// The graph gets at least as many vertices as the input declares
+/// @tparam G - Graph Class Template, with a build_from_edges function
+/// @param path - the path of the file
+/// @param format - the format of the input
+/// @param graph - a graph
+/// @throws std::runtime_error if the file cannot be mapped, a line does not belong to the format, or a vertex does not fit the vertex_descriptor of the graph
+///
+template <typename G>
+void load_edge_list (const std::string& path, edge_list_format format, G& graph)
+{
+	typedef std::vector<edge_list_parser::edge_descriptor> batch_type;
+	std::uint64_t n = read_edge_list(path, format, [&] (const batch_type& edges)
+	{
+		check_vertex_ids<G>(edges);
+		build_from_edges(edges.begin(), edges.end(), 0, graph);
+	});
+	if(n != 0)
+		check_vertex_id<G>(n - 1);
+	batch_type none;
+	build_from_edges(none.begin(), none.end(), n, graph);
+}
+
+///
+/// Add the edges of an edge list file to a graph, parsing one chunk per thread of the pool
+/// The batches are added to the graph one at a time
+/// @tparam G - Graph Class Template, with a build_from_edges function
+/// @param path - the path of the file
+/// @param format - the format of the input
+/// @param graph - a graph
+/// @param pool - the threads that parse the file
+/// @throws std::runtime_error if the file cannot be mapped, a line does not belong to the format, or a vertex does not fit the vertex_descriptor of the graph
+///
+template <typename G>
+void load_edge_list (const std::string& path, edge_list_format format, G& graph, ThreadPool& pool)
+{
+	typedef std::vector<edge_list_parser::edge_descriptor> batch_type;
+	std::uint64_t n = read_edge_list(path, format, [&] (const batch_type& edges)
+	{
+		check_vertex_ids<G>(edges);
+		build_from_edges(edges.begin(), edges.end(), 0, graph);
+	}, pool);
+	if(n != 0)
+		check_vertex_id<G>(n - 1);
+	batch_type none;
+	build_from_edges(none.begin(), none.end(), n, graph);
+}
+
+#endif // GraphReader_h
@@ -0,0 +1,490 @@
+// ------------------------------
+// projects/graph/GraphSnapshot.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef GraphSnapshot_h
+#define GraphSnapshot_h
+
+// --------
+// includes
+// --------
+#include <boost/iterator/counting_iterator.hpp>
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fchmod, fstat
+#include <unistd.h> // close, fsync, unlink, write
+#include <cassert> // assert
+#include <cerrno> // errno, EINTR
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <cstdio> // rename
+#include <cstdlib> // mkstemp
+#include <cstring> // memcmp, memcpy
+#include <algorithm> // binary_search, sort
+#include <stdexcept> // runtime_error
+#include <string> // string
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "CSRGraph.h" // csr_edge_iterator
+
+
+// ---------------
+// snapshot_header
+// ---------------
+
+///
+/// The header at the start of a graph snapshot file
+/// The header is followed by num_vertices + 1 row offsets and num_edges targets, all unsigned 64-bit words in the writer's byte order
+/// The targets of each row are in ascending order
+///
+struct snapshot_header
+{
+	char magic[8]; // "GRAPHCSR"
+	std::uint32_t version;
+	std::uint32_t byte_order; // snapshot_byte_order, as written by the writer
+	std::uint64_t num_vertices;
+	std::uint64_t num_edges;
+	std::uint64_t payload_checksum; // checksum of the offsets and targets
+	std::uint64_t header_checksum; // checksum of the preceding header fields
+};
+
+static_assert(sizeof(snapshot_header) == 48, "snapshot_header must not have padding");
+
+const char snapshot_magic[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+const std::uint32_t snapshot_version = 1;
+const std::uint32_t snapshot_byte_order = 0x01020304;
+
+// -----------------
+// snapshot_checksum
+// -----------------
+
+///
+/// Fold a range of 64-bit words into a running checksum
+/// Each word is mixed with a multiply and xor-shift step, which runs at memory bandwidth on large arrays
+/// @param b - the beginning of the words
+/// @param e - the end of the words
+/// @param h - the running checksum
+/// @return the checksum of the words that were folded so far
+///
+inline std::uint64_t snapshot_checksum (const std::uint64_t* b, const std::uint64_t* e, std::uint64_t h = 0xcbf29ce484222325ull)
+{
+	for(; b != e; ++b)
+	{
+		h = (h ^ *b) * 0x100000001b3ull;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+///
+/// @param header - a snapshot header
+/// @return the checksum of the header fields before header_checksum
+///
+inline std::uint64_t snapshot_checksum (const snapshot_header& header)
+{
+	std::uint64_t words[sizeof(snapshot_header) / sizeof(std::uint64_t) - 1];
+	std::memcpy(words, &header, sizeof(words));
+	return snapshot_checksum(words, words + sizeof(words) / sizeof(std::uint64_t));
+}
+
+// --------------
+// write_snapshot
+// --------------
+
+///
+/// A helper function for save_snapshot
+/// Write a whole buffer to a file, resuming after partial writes and interrupted calls
+/// @param fd - an open file descriptor
+/// @param p - the beginning of the buffer
+/// @param n - the size of the buffer in bytes
+/// @return true if every byte was written
+///
+inline bool write_snapshot (int fd, const void* p, std::size_t n)
+{
+	const char* b = static_cast<const char*>(p);
+	while(n != 0)
+	{
+		const ssize_t written = write(fd, b, n);
+		if(written < 0 && errno == EINTR)
+			continue;
+		if(written <= 0)
+			return false;
+		b += written;
+		n -= written;
+	}
+	return true;
+}
+
+// -------------
+// save_snapshot
+// -------------
+
+///
+/// Write a graph to a snapshot file that MappedGraph can map without deserialization
+/// The snapshot is written to a temporary file in the same directory, flushed to disk, and renamed over the path
+/// A MappedGraph that already maps an older snapshot at the path keeps mapping the old file, which the rename unlinks but never changes, so one process can replace a snapshot while others read it
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param path - the path of the snapshot file, which is replaced if it exists
+/// @throws std::runtime_error if the file cannot be written
+///
+template <typename G>
+void save_snapshot (const G& graph, const std::string& path)
+{
+	std::vector<std::uint64_t> offsets;
+	std::vector<std::uint64_t> targets;
+	offsets.reserve(num_vertices(graph) + 1);
+	targets.reserve(num_edges(graph));
+	offsets.push_back(0);
+
+	std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(graph);
+	while(v.first != v.second)
+	{
+		std::size_t b = targets.size();
+		std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(*v.first, graph);
+		targets.insert(targets.end(), av.first, av.second);
+		std::sort(targets.begin() + b, targets.end());
+		offsets.push_back(targets.size());
+		++v.first;
+	}
+
+	snapshot_header header;
+	std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+	header.version = snapshot_version;
+	header.byte_order = snapshot_byte_order;
+	header.num_vertices = offsets.size() - 1;
+	header.num_edges = targets.size();
+	header.payload_checksum = snapshot_checksum(targets.data(), targets.data() + targets.size(), snapshot_checksum(offsets.data(), offsets.data() + offsets.size()));
+	header.header_checksum = snapshot_checksum(header);
+
+	std::vector<char> temporary(path.begin(), path.end());
+	const char suffix[] = ".XXXXXX";
+	temporary.insert(temporary.end(), suffix, suffix + sizeof(suffix));
+	const int fd = mkstemp(temporary.data());
+	if(fd < 0)
+		throw std::runtime_error("cannot write graph snapshot " + path);
+	bool written = fchmod(fd, 0644) == 0
+		&& write_snapshot(fd, &header, sizeof(header))
+		&& write_snapshot(fd, offsets.data(), offsets.size() * sizeof(std::uint64_t))
+		&& write_snapshot(fd, targets.data(), targets.size() * sizeof(std::uint64_t))
+		&& fsync(fd) == 0;
+	written = close(fd) == 0 && written;
+	if(!written || std::rename(temporary.data(), path.c_str()) != 0)
+	{
+		unlink(temporary.data());
+		throw std::runtime_error("cannot write graph snapshot " + path);
+	}
+}
+
+// -----------
+// MappedGraph
+// -----------
+
+///
+/// A read-only directed graph mapped from a snapshot file written by save_snapshot
+/// Opening a snapshot only validates its header, its size, and its first and last row offsets, so it costs O(1) regardless of the size of the graph
+/// The pages of the file are shared through the page cache by every process that maps the same snapshot
+/// The other row offsets and the targets are trusted until verify, which reads the whole file, accepts them
+///
+class MappedGraph
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::uint64_t vertices_size_type;
+	typedef std::uint64_t edges_size_type;
+
+	typedef std::uint64_t vertex_descriptor;
+	typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor; // source, target
+
+	typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+	typedef const vertex_descriptor* adjacency_iterator;
+	typedef csr_edge_iterator<vertex_descriptor, edges_size_type> edge_iterator;
+
+public:
+	// -----------------
+	// adjacent_vertices
+	// -----------------
+
+	///
+    /// Provide access to the adjacent vertices to the source vertex in the graph
+    /// For example, if an edge from vertex u to vertex v exists in the graph, the vertex v is an adjacent vertex.
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param graph - a graph
+    /// @return an iterator range representing the vertices adjacent to the source vertex in the graph
+    ///
+	friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor source, const MappedGraph& graph)
+	{
+		return std::make_pair(graph.targets + graph.offsets[source], graph.targets + graph.offsets[source + 1]);
+	}
+
+	// ----
+	// edge
+	// ----
+
+	///
+    /// Find the edge between a source and target vertex to the graph with a binary search of the source's row
+    /// @param source - a vertex descriptor for the source vertex
+    /// @param target - a vertex descriptor for the target vertex
+    /// @param graph - a graph
+    /// @return a std::pair<edge_descriptor, bool> - The edge_descriptor for the edge is returned regardless if the edge is present in the graph. The bool value is true if the edge is present. Otherwise, the bool value is false.
+    ///
+	friend std::pair<edge_descriptor, bool> edge (vertex_descriptor source, vertex_descriptor target, const MappedGraph& graph)
+	{
+		edge_descriptor ed = std::make_pair(source, target);
+		if(source < num_vertices(graph))
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(source, graph);
+			return std::make_pair(ed, std::binary_search(av.first, av.second, target));
+		}
+		return std::make_pair(ed, false);
+	}
+
+	// -----
+	// edges
+	// -----
+
+	///
+    /// Provide access to the edges in the graph
+    /// @param graph - a graph
+    /// @return an iterator range representing the edges in the graph
+    ///
+	friend std::pair<edge_iterator, edge_iterator> edges (const MappedGraph& graph)
+	{
+		edge_iterator b(graph.offsets, graph.targets, num_vertices(graph), 0);
+		edge_iterator e(graph.offsets, graph.targets, num_vertices(graph), num_edges(graph));
+		return std::make_pair(b, e);
+	}
+
+	// ---------
+	// num_edges
+	// ---------
+
+	///
+    /// Determine the number of edges in the graph
+    /// @param graph - a graph
+    /// @return the number of edges in the graph
+    ///
+	friend edges_size_type num_edges (const MappedGraph& graph)
+	{
+		return graph.header->num_edges;
+	}
+
+	// ------------
+	// num_vertices
+	// ------------
+
+	///
+    /// Determine the number of vertices in the graph
+    /// @param graph - a graph
+    /// @return the number of vertices in the graph
+    ///
+	friend vertices_size_type num_vertices (const MappedGraph& graph)
+	{
+		return graph.header->num_vertices;
+	}
+
+	// ------
+	// source
+	// ------
+
+    ///
+    /// Access the source vertex of an edge in a graph
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the source vertex
+    ///
+	friend vertex_descriptor source (edge_descriptor edge, const MappedGraph& graph)
+	{
+		return edge.first;
+	}
+
+	// ------
+	// target
+	// ------
+
+    ///
+    /// Access the target vertex of an edge in a graph
+    /// @param edge - the edge descriptor representing the edge in the graph
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the target vertex
+    ///
+	friend vertex_descriptor target (edge_descriptor edge, const MappedGraph& graph)
+	{
+		return edge.second;
+	}
+
+	// ------
+	// vertex
+	// ------
+
+    ///
+    /// Access the nth vertex of the graph
+    /// @param index - the nth position in the graph's vertex list
+    /// @param graph - a graph
+    /// @return the vertex descriptor of the nth vertex in the graph's vertex list
+    ///
+	friend vertex_descriptor vertex (vertices_size_type index, const MappedGraph& graph)
+	{
+		return index;
+	}
+
+	// --------
+	// vertices
+	// --------
+
+    ///
+    /// Provide access to the vertices in the graph
+    /// @param graph - a graph
+    /// @return an iterator range representing the vertices in the graph
+    ///
+	friend std::pair<vertex_iterator, vertex_iterator> vertices (const MappedGraph& graph)
+	{
+		return std::make_pair(vertex_iterator(0), vertex_iterator(num_vertices(graph)));
+	}
+
+	// ------
+	// verify
+	// ------
+
+    ///
+    /// Check the payload of the snapshot, which reads every page of the file: O(V + E)
+    /// A file that was written with a matching checksum on purpose still has to hold a graph, so the rows are checked as well
+    /// @param graph - a graph
+    /// @return true if the offsets and targets match the checksum written by save_snapshot, the row offsets do not decrease, and the targets of each row are ascending vertices of the graph
+    ///
+	friend bool verify (const MappedGraph& graph)
+	{
+		const std::uint64_t* b = graph.offsets;
+		const std::uint64_t* e = graph.targets + num_edges(graph);
+		if(snapshot_checksum(b, e) != graph.header->payload_checksum)
+			return false;
+		for(vertices_size_type v = 0; v != num_vertices(graph); ++v)
+		{
+			if(graph.offsets[v + 1] < graph.offsets[v])
+				return false;
+			for(edges_size_type i = graph.offsets[v]; i != graph.offsets[v + 1]; ++i)
+			{
+				if(graph.targets[i] >= num_vertices(graph) || (i != graph.offsets[v] && graph.targets[i] <= graph.targets[i - 1]))
+					return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	// ----
+	// data
+	// ----
+	void* base; // the mapping of the whole file
+	std::size_t length;
+	const snapshot_header* header;
+	const edges_size_type* offsets; // Row offsets, one per vertex plus one
+	const vertex_descriptor* targets; // Adjacent vertices of every row, ascending within a row
+
+	// -----
+	// valid
+	// -----
+
+	///
+	/// @return true if the MappedGraph object is in a valid state
+	///
+	bool valid () const
+	{
+		return base != nullptr && offsets[0] == 0 && offsets[header->num_vertices] == header->num_edges;
+	}
+
+	// -----
+	// fail
+	// -----
+
+	///
+	/// Release the mapping and report a snapshot that cannot be used
+	/// @param path - the path of the snapshot file
+	/// @param reason - what is wrong with the snapshot
+	/// @throws std::runtime_error always
+	///
+	void fail (const std::string& path, const std::string& reason)
+	{
+		if(base != nullptr)
+			munmap(base, length);
+		base = nullptr;
+		throw std::runtime_error("invalid graph snapshot " + path + ": " + reason);
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Map a snapshot file read-only and validate its header
+	/// @param path - the path of a file written by save_snapshot
+	/// @throws std::runtime_error if the file cannot be mapped, or its header is not a valid snapshot header
+	///
+	explicit MappedGraph (const std::string& path) : base(nullptr), length(0), header(nullptr), offsets(nullptr), targets(nullptr)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if(fd < 0)
+			fail(path, "cannot open file");
+		struct stat st;
+		if(fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(snapshot_header))
+		{
+			close(fd);
+			fail(path, "file is too short");
+		}
+		length = st.st_size;
+		void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if(p == MAP_FAILED)
+			fail(path, "cannot map file");
+		base = p;
+
+		header = static_cast<const snapshot_header*>(base);
+		if(std::memcmp(header->magic, snapshot_magic, sizeof(header->magic)) != 0)
+			fail(path, "bad magic");
+		if(header->byte_order != snapshot_byte_order)
+			fail(path, "byte order mismatch");
+		if(header->version != snapshot_version)
+			fail(path, "unsupported version");
+		if(header->header_checksum != snapshot_checksum(*header))
+			fail(path, "header checksum mismatch");
+		// Count the words of the payload instead of sizing the header's counts, which a crafted header could make wrap
+		const std::size_t words = (length - sizeof(snapshot_header)) / sizeof(std::uint64_t);
+		if((length - sizeof(snapshot_header)) % sizeof(std::uint64_t) != 0 || header->num_vertices >= words || header->num_edges != words - header->num_vertices - 1)
+			fail(path, "file size does not match header");
+
+		offsets = reinterpret_cast<const edges_size_type*>(header + 1);
+		targets = offsets + header->num_vertices + 1;
+		if(!valid())
+			fail(path, "offsets do not match header");
+	}
+
+	///
+	/// Move Constructor - takes over the mapping of another MappedGraph
+	/// @param other - the MappedGraph to move from, which is left without a mapping
+	///
+	MappedGraph (MappedGraph&& other) : base(other.base), length(other.length), header(other.header), offsets(other.offsets), targets(other.targets)
+	{
+		other.base = nullptr;
+	}
+
+	///
+	/// Destructor - unmaps the snapshot file
+	///
+	~MappedGraph ()
+	{
+		if(base != nullptr)
+			munmap(base, length);
+	}
+
+	MappedGraph (const MappedGraph&) = delete;
+	MappedGraph& operator = (const MappedGraph&) = delete;
+};
+
+#endif // GraphSnapshot_h
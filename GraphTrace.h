@@ -0,0 +1,360 @@
+// ---------------------------
+// projects/graph/GraphTrace.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef GraphTrace_h
+#define GraphTrace_h
+
+// --------
+// includes
+// --------
+#include <chrono> // duration_cast, nanoseconds, steady_clock
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <ostream> // ostream
+#include <vector> // vector
+
+
+// ------------
+// GRAPH_TRACE
+// ------------
+
+///
+/// The algorithms of the graph library count their work only when GRAPH_TRACE is defined, for every translation unit of a program
+/// Without it the macros below expand to nothing, so an untraced build has no extra loads, branches, or clock reads
+/// GRAPH_TRACE_COUNT(counter, n) adds n to a field of graph_counters
+/// GRAPH_TRACE_DEPTH(d) raises max_depth to d
+/// GRAPH_TRACE_PHASE(name) times the rest of the enclosing block as a phase with the given name, a string literal
+///
+#ifdef GRAPH_TRACE
+#define GRAPH_TRACE_COUNT(counter, n) graph_trace::count(&graph_counters::counter, (n))
+#define GRAPH_TRACE_DEPTH(d) graph_trace::depth(d)
+#define GRAPH_TRACE_CONCAT_(a, b) a ## b
+#define GRAPH_TRACE_CONCAT(a, b) GRAPH_TRACE_CONCAT_(a, b)
+#define GRAPH_TRACE_PHASE(name) trace_phase GRAPH_TRACE_CONCAT(graph_trace_phase_, __LINE__)(name)
+#else
+#define GRAPH_TRACE_COUNT(counter, n) ((void)0)
+#define GRAPH_TRACE_DEPTH(d) ((void)0)
+#define GRAPH_TRACE_PHASE(name) ((void)0)
+#endif
+
+// --------------
+// graph_counters
+// --------------
+
+///
+/// The work that the graph algorithms did while a graph_trace was open
+/// vertices_visited: the vertices that a traversal discovered, once per traversal; a vertex that several calls explore is counted by each
+/// edges_scanned: the adjacent vertices that a traversal read
+/// edge_lookups: the calls to edge, including the one that add_edge makes to reject a duplicate
+/// allocations: the blocks that a graph took from the global allocator, for its vertex table or for its arena
+/// max_depth: the longest search path of a depth-first traversal
+///
+struct graph_counters
+{
+	std::size_t vertices_visited;
+	std::size_t edges_scanned;
+	std::size_t edge_lookups;
+	std::size_t allocations;
+	std::size_t max_depth;
+};
+
+// -----------
+// trace_event
+// -----------
+
+///
+/// One timed phase of a graph_trace, in nanoseconds from the opening of the trace
+/// depth is the number of phases that enclosed it, so nested phases can be told apart from consecutive ones
+///
+struct trace_event
+{
+	const char* name;
+	std::uint64_t start;
+	std::uint64_t duration;
+	std::size_t depth;
+};
+
+// -----------
+// graph_trace
+// -----------
+
+///
+/// A record of the work that the graph algorithms do on one thread, from its construction to its destruction
+/// Open a graph_trace around a call, or around every call on one graph, to get the counters of that call or that graph
+/// Traces nest: an inner trace records the work done while it is open, and the outer trace resumes when it closes
+/// Work that a ThreadPool runs on its own threads is not counted, but the phases of the calling thread time it
+/// Without GRAPH_TRACE the counters stay zero and no phases are recorded
+///
+class graph_trace
+{
+private:
+	// ----
+	// data
+	// ----
+	graph_counters totals;
+	std::vector<trace_event> phases;
+	std::chrono::steady_clock::time_point origin;
+	std::size_t open; // The number of phases that are running
+	graph_trace* outer; // The trace that this one interrupted, or null
+
+	friend class trace_phase;
+
+private:
+	// -------
+	// current
+	// -------
+
+	///
+	/// @return the innermost open trace of this thread, or null
+	///
+	static graph_trace*& current ()
+	{
+		static thread_local graph_trace* trace = nullptr;
+		return trace;
+	}
+
+	// -----------
+	// nanoseconds
+	// -----------
+
+	///
+	/// @return the time since the trace was opened
+	///
+	std::uint64_t nanoseconds () const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+	}
+
+	// ------
+	// escape
+	// ------
+
+	///
+	/// Write a phase name as a JSON string
+	/// @param out - a stream
+	/// @param name - a phase name
+	///
+	static void escape (std::ostream& out, const char* name)
+	{
+		out << '"';
+		for(; *name != '\0'; ++name)
+		{
+			if(*name == '"' || *name == '\\')
+				out << '\\';
+			out << *name;
+		}
+		out << '"';
+	}
+
+	// --------------
+	// write_counters
+	// --------------
+
+	///
+	/// Write the counters as the members of a JSON object
+	/// @param out - a stream
+	///
+	void write_counters (std::ostream& out) const
+	{
+		out << "{\"vertices_visited\": " << totals.vertices_visited
+			<< ", \"edges_scanned\": " << totals.edges_scanned
+			<< ", \"edge_lookups\": " << totals.edge_lookups
+			<< ", \"allocations\": " << totals.allocations
+			<< ", \"max_depth\": " << totals.max_depth << "}";
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - opens the trace on this thread, with every counter at zero
+	///
+	graph_trace () : totals(), origin(std::chrono::steady_clock::now()), open(0), outer(current())
+	{
+		current() = this;
+	}
+
+	///
+	/// Destructor - closes the trace, and resumes the one it interrupted
+	///
+	~graph_trace ()
+	{
+		current() = outer;
+	}
+
+	graph_trace (const graph_trace&) = delete;
+	graph_trace& operator = (const graph_trace&) = delete;
+
+	// -----
+	// count
+	// -----
+
+	///
+	/// Add to a counter of the innermost open trace of this thread, if there is one
+	/// @param counter - a field of graph_counters
+	/// @param n - the amount to add
+	///
+	static void count (std::size_t graph_counters::* counter, std::size_t n)
+	{
+		graph_trace* trace = current();
+		if(trace != nullptr)
+			trace->totals.*counter += n;
+	}
+
+	// -----
+	// depth
+	// -----
+
+	///
+	/// Raise the max_depth of the innermost open trace of this thread, if there is one
+	/// @param d - the depth of a search path
+	///
+	static void depth (std::size_t d)
+	{
+		graph_trace* trace = current();
+		if(trace != nullptr && d > trace->totals.max_depth)
+			trace->totals.max_depth = d;
+	}
+
+	// --------
+	// counters
+	// --------
+
+	///
+	/// @return the counters so far
+	///
+	const graph_counters& counters () const
+	{
+		return totals;
+	}
+
+	// ------
+	// events
+	// ------
+
+	///
+	/// @return the phases that have finished, in the order they finished
+	///
+	const std::vector<trace_event>& events () const
+	{
+		return phases;
+	}
+
+	// -----
+	// clear
+	// -----
+
+	///
+	/// Zero the counters and forget the phases, to reuse the trace for another call
+	///
+	void clear ()
+	{
+		totals = graph_counters();
+		phases.clear();
+		origin = std::chrono::steady_clock::now();
+	}
+
+	// ----------
+	// write_json
+	// ----------
+
+	///
+	/// Write the counters and the phases as one JSON object, with the times in microseconds
+	/// @param out - a stream
+	///
+	void write_json (std::ostream& out) const
+	{
+		out << "{\"counters\": ";
+		write_counters(out);
+		out << ", \"phases\": [";
+		for(std::size_t i = 0; i != phases.size(); ++i)
+		{
+			out << (i == 0 ? "" : ", ") << "{\"name\": ";
+			escape(out, phases[i].name);
+			out << ", \"start_us\": " << phases[i].start / 1000.0 << ", \"duration_us\": " << phases[i].duration / 1000.0 << ", \"depth\": " << phases[i].depth << "}";
+		}
+		out << "]}";
+	}
+
+	// ------------------
+	// write_chrome_trace
+	// ------------------
+
+	///
+	/// Write the phases as complete events, and the counters as one counter event at the end, in the Trace Event Format that chrome://tracing and Perfetto load
+	/// @param out - a stream
+	///
+	void write_chrome_trace (std::ostream& out) const
+	{
+		out << "{\"traceEvents\": [";
+		for(const trace_event& e : phases)
+		{
+			out << "{\"name\": ";
+			escape(out, e.name);
+			out << ", \"cat\": \"graph\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << e.start / 1000.0 << ", \"dur\": " << e.duration / 1000.0 << "}, ";
+		}
+		out << "{\"name\": \"graph_counters\", \"ph\": \"C\", \"pid\": 1, \"tid\": 1, \"ts\": " << nanoseconds() / 1000.0 << ", \"args\": ";
+		write_counters(out);
+		out << "}]}";
+	}
+};
+
+// -----------
+// trace_phase
+// -----------
+
+///
+/// A timer that records its lifetime as a phase of the innermost open trace of this thread, if there is one
+/// Use it through GRAPH_TRACE_PHASE, which leaves it out of an untraced build
+///
+class trace_phase
+{
+private:
+	// ----
+	// data
+	// ----
+	graph_trace* trace;
+	const char* name;
+	std::uint64_t start;
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Start the phase
+	/// @param n - the name of the phase, which must outlive the trace, such as a string literal
+	///
+	explicit trace_phase (const char* n) : trace(graph_trace::current()), name(n), start(0)
+	{
+		if(trace != nullptr)
+		{
+			start = trace->nanoseconds();
+			++trace->open;
+		}
+	}
+
+	///
+	/// Finish the phase, also when an exception leaves it
+	///
+	~trace_phase ()
+	{
+		if(trace != nullptr)
+		{
+			--trace->open;
+			trace_event e = {name, start, trace->nanoseconds() - start, trace->open};
+			trace->phases.push_back(e);
+		}
+	}
+
+	trace_phase (const trace_phase&) = delete;
+	trace_phase& operator = (const trace_phase&) = delete;
+};
+
+#endif // GraphTrace_h
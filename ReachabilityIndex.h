@@ -0,0 +1,448 @@
+// ----------------------------------
+// projects/graph/ReachabilityIndex.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------------
+
+#ifndef ReachabilityIndex_h
+#define ReachabilityIndex_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // copy, max, merge, sort, upper_bound
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <iterator> // back_inserter
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "Graph.h" // topological_levels, topological_sort
+#include "ThreadPool.h" // ThreadPool
+#include "TriangleCount.h" // intersection_isa, TRIANGLE_COUNT_X86
+
+
+// ---------
+// constants
+// ---------
+
+const std::size_t reachability_dense_bytes = std::size_t(1) << 28; // the largest bitset table that a reachability_index builds by default, 256 MiB, or 46000 vertices
+
+// --------
+// or_words
+// --------
+
+///
+/// OR one array of words into another
+/// @param d - the destination
+/// @param s - the source
+/// @param n - the number of words
+///
+inline void or_words_scalar (std::uint64_t* d, const std::uint64_t* s, std::size_t n)
+{
+	for(std::size_t i = 0; i != n; ++i)
+		d[i] |= s[i];
+}
+
+#ifdef TRIANGLE_COUNT_X86
+
+///
+/// OR one array of words into another, four words per instruction, and the last words one by one
+/// @param d - the destination
+/// @param s - the source
+/// @param n - the number of words
+///
+__attribute__((target("avx2")))
+inline void or_words_avx2 (std::uint64_t* d, const std::uint64_t* s, std::size_t n)
+{
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+		const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_or_si256(x, y));
+	}
+	or_words_scalar(d + i, s + i, n - i);
+}
+
+#endif // TRIANGLE_COUNT_X86
+
+///
+/// OR one array of words into another with the widest kernel that the processor has
+/// @param d - the destination
+/// @param s - the source
+/// @param n - the number of words
+/// @param isa - the instruction set, from intersection_isa
+///
+inline void or_words (std::uint64_t* d, const std::uint64_t* s, std::size_t n, intersect_isa isa)
+{
+#ifdef TRIANGLE_COUNT_X86
+	if(isa == isa_avx2)
+	{
+		or_words_avx2(d, s, n);
+		return;
+	}
+#endif
+	or_words_scalar(d, s, n);
+}
+
+// ------------------
+// reachability_index
+// ------------------
+
+///
+/// The transitive closure of a directed, acyclic graph, for queries of whether one vertex reaches another
+/// A vertex reaches itself, and every vertex at the end of a path from it
+/// A small graph gets a bitset of descendants per vertex, and a query is one bit probe
+/// Each bitset is the OR of the bitsets of the vertex's adjacent vertices, so the bitsets are built in reverse topological order, a machine word or an AVX2 register at a time
+/// When the bitsets would take more than max_dense_bytes, each vertex gets a sorted list of intervals of postorder numbers instead
+/// The vertices below a vertex in the depth-first tree of topological_sort have consecutive postorder numbers, so the descendants of a vertex compress to a few intervals, and a query is a binary search of them
+/// Only the edges of the transitive reduction merge bitsets or intervals; an edge to a vertex that the source already reaches through another edge is skipped
+/// The index does not follow changes to the graph; it is rebuilt, which the pool constructor does level by level with every thread
+/// @tparam V - the vertex descriptor type
+///
+template <typename V = std::size_t>
+class reachability_index
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef V vertex_descriptor;
+	typedef std::pair<std::size_t, std::size_t> interval; // first and last postorder number
+
+private:
+	// ----
+	// data
+	// ----
+	std::size_t n; // The number of vertices
+	std::size_t words; // The words per bitset, or 0 for intervals
+	std::vector<std::uint64_t> bits; // The bitset of vertex v is bits[v * words] through bits[v * words + words - 1]
+	std::vector<std::size_t> post; // The postorder number of each vertex
+	std::vector<vertex_descriptor> order; // The vertex of each postorder number
+	std::vector<std::vector<interval> > spans; // The postorder intervals that each vertex reaches, sorted and disjoint
+
+private:
+	// ------
+	// covers
+	// ------
+
+	///
+	/// @param s - sorted, disjoint intervals
+	/// @param p - a postorder number
+	/// @return true if one of the intervals holds the number
+	///
+	static bool covers (const std::vector<interval>& s, std::size_t p)
+	{
+		typename std::vector<interval>::const_iterator i = std::upper_bound(s.begin(), s.end(), std::make_pair(p, std::size_t(-1)));
+		return i != s.begin() && (i - 1)->second >= p;
+	}
+
+	// -----
+	// unite
+	// -----
+
+	///
+	/// Replace a list of intervals with its union with another, joining the intervals that overlap or touch, in time linear in both
+	/// @param a - sorted, disjoint intervals, which receive the union
+	/// @param b - sorted, disjoint intervals
+	///
+	static void unite (std::vector<interval>& a, const std::vector<interval>& b)
+	{
+		std::vector<interval> all(a.size() + b.size());
+		std::merge(a.begin(), a.end(), b.begin(), b.end(), all.begin());
+		a.clear();
+		for(const interval& x : all)
+		{
+			if(!a.empty() && x.first <= a.back().second + 1)
+				a.back().second = std::max(a.back().second, x.second);
+			else
+				a.push_back(x);
+		}
+	}
+
+	// ----
+	// fill
+	// ----
+
+	///
+	/// Build the bitset or the intervals of one vertex from the finished ones of its adjacent vertices
+	/// The adjacent vertices are taken by descending rank, so one that another adjacent vertex reaches comes later and is found already reached
+	/// Its descendants are then already reached too, and it is skipped, so only the edges of the transitive reduction are merged
+	/// @tparam G - Graph Class Template
+	/// @param graph - a graph
+	/// @param u - a vertex
+	/// @param rank - a number per vertex that is greater than the number of every other vertex it reaches
+	/// @param isa - the instruction set, from intersection_isa
+	/// @param adjacent - scratch space for the adjacent vertices, reused from vertex to vertex
+	///
+	template <typename G>
+	void fill (const G& graph, vertex_descriptor u, const std::vector<std::size_t>& rank, intersect_isa isa, std::vector<vertex_descriptor>& adjacent)
+	{
+		std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> av = adjacent_vertices(u, graph);
+		adjacent.assign(av.first, av.second);
+		std::sort(adjacent.begin(), adjacent.end(), [&] (vertex_descriptor x, vertex_descriptor y) -> bool
+		{
+			return rank[x] > rank[y];
+		});
+
+		if(words != 0)
+		{
+			std::uint64_t* row = &bits[u * words];
+			row[u / 64] |= std::uint64_t(1) << (u % 64);
+			for(vertex_descriptor v : adjacent)
+			{
+				if(((row[v / 64] >> (v % 64)) & 1) == 0)
+					or_words(row, &bits[v * words], words, isa);
+			}
+			return;
+		}
+		std::vector<interval>& merged = spans[u];
+		merged.assign(1, std::make_pair(post[u], post[u]));
+		for(vertex_descriptor v : adjacent)
+		{
+			if(!covers(merged, post[v]))
+				unite(merged, spans[v]);
+		}
+		merged.shrink_to_fit();
+	}
+
+	// -----
+	// setup
+	// -----
+
+	///
+	/// Choose the representation and allocate it
+	/// An interval index numbers the vertices in postorder with topological_sort
+	/// @tparam G - Graph Class Template
+	/// @param graph - a graph
+	/// @param max_dense_bytes - the largest bitset table to build
+	///
+	template <typename G>
+	void setup (const G& graph, std::size_t max_dense_bytes)
+	{
+		n = num_vertices(graph);
+		const std::size_t w = (n + 63) / 64;
+		if(n == 0 || w <= max_dense_bytes / sizeof(std::uint64_t) / n)
+		{
+			words = w;
+			bits.assign(n * words, 0);
+			return;
+		}
+		words = 0;
+		spans.resize(n);
+		order.reserve(n);
+		topological_sort(graph, std::back_inserter(order));
+		post.resize(n);
+		for(std::size_t i = 0; i != n; ++i)
+			post[order[i]] = i;
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - the index of a graph without vertices
+	///
+	reachability_index () : n(0), words(0)
+	{
+	}
+
+	///
+	/// Build the index of a graph, in reverse topological order
+	/// @tparam G - Graph Class Template
+	/// @param graph - a directed, acyclic graph
+	/// @param max_dense_bytes - the largest bitset table to build, above which the index keeps intervals
+	/// @throws Boost's not_a_dag exception if the graph has a cycle
+	///
+	template <typename G>
+	explicit reachability_index (const G& graph, std::size_t max_dense_bytes = reachability_dense_bytes)
+	{
+		setup(graph, max_dense_bytes);
+
+		// A postorder is a reverse topological order, and a vertex's postorder number is greater than those of the vertices it reaches
+		std::vector<vertex_descriptor> reversed;
+		std::vector<std::size_t> rank;
+		if(words != 0)
+		{
+			reversed.reserve(n);
+			topological_sort(graph, std::back_inserter(reversed));
+			rank.resize(n);
+			for(std::size_t i = 0; i != n; ++i)
+				rank[reversed[i]] = i;
+		}
+		const intersect_isa isa = intersection_isa();
+		std::vector<vertex_descriptor> adjacent;
+		for(vertex_descriptor u : words != 0 ? reversed : order)
+			fill(graph, u, words != 0 ? rank : post, isa, adjacent);
+	}
+
+	///
+	/// Build the index of a graph with every thread of the pool
+	/// The vertices of a topological level do not reach each other, so the levels are built from the last to the first, each in parallel
+	/// @tparam G - Graph Class Template
+	/// @param graph - a directed, acyclic graph
+	/// @param pool - the threads that build the index
+	/// @param max_dense_bytes - the largest bitset table to build, above which the index keeps intervals
+	/// @throws Boost's not_a_dag exception if the graph has a cycle
+	///
+	template <typename G>
+	reachability_index (const G& graph, ThreadPool& pool, std::size_t max_dense_bytes = reachability_dense_bytes)
+	{
+		const std::vector<std::vector<vertex_descriptor> > levels = topological_levels(graph, pool);
+		setup(graph, max_dense_bytes);
+
+		// A vertex is on an earlier level than every other vertex it reaches
+		std::vector<std::size_t> rank;
+		if(words != 0)
+		{
+			rank.resize(n);
+			for(std::size_t d = 0; d != levels.size(); ++d)
+			{
+				for(vertex_descriptor v : levels[d])
+					rank[v] = levels.size() - d;
+			}
+		}
+		const std::vector<std::size_t>& ranks = words != 0 ? rank : post;
+		const intersect_isa isa = intersection_isa();
+		for(std::size_t d = levels.size(); d-- != 0; )
+		{
+			const std::vector<vertex_descriptor>& level = levels[d];
+			pool.parallel_for(0, level.size(), [&] (std::size_t b, std::size_t e)
+			{
+				std::vector<vertex_descriptor> adjacent;
+				for(std::size_t i = b; i < e; ++i)
+					fill(graph, level[i], ranks, isa, adjacent);
+			});
+		}
+	}
+
+	// Default copy, destructor, and copy assignment
+	// reachability_index (const reachability_index&);
+	// ~reachability_index ();
+	// reachability_index& operator = (const reachability_index&);
+
+	// -----
+	// dense
+	// -----
+
+	///
+	/// @return true if the index keeps a bitset per vertex, and false if it keeps intervals
+	///
+	bool dense () const
+	{
+		return words != 0 || n == 0;
+	}
+
+	// ----
+	// size
+	// ----
+
+	///
+	/// @return the number of vertices of the graph
+	///
+	std::size_t size () const
+	{
+		return n;
+	}
+
+	// -------
+	// reaches
+	// -------
+
+	///
+	/// Determine whether there is a path from one vertex to another, in O(1) time for a bitset index and O(log k) time for k intervals
+	/// @param u - the first vertex
+	/// @param v - the second vertex
+	/// @return true if u is v or there is a path from u to v; Otherwise, false
+	///
+	bool reaches (vertex_descriptor u, vertex_descriptor v) const
+	{
+		if(words != 0)
+			return (bits[u * words + v / 64] >> (v % 64)) & 1;
+		return covers(spans[u], post[v]);
+	}
+
+	// -----------
+	// descendants
+	// -----------
+
+	///
+	/// Write the vertices that a vertex reaches, itself included, in ascending order
+	/// @tparam OI - Output Iterator Template
+	/// @param u - a vertex
+	/// @param x - an output iterator, which receives the vertices
+	///
+	template <typename OI>
+	void descendants (vertex_descriptor u, OI x) const
+	{
+		if(words != 0)
+		{
+			const std::uint64_t* row = &bits[u * words];
+			for(std::size_t i = 0; i != words; ++i)
+			{
+				for(std::uint64_t w = row[i]; w != 0; w &= w - 1)
+				{
+					*x = static_cast<vertex_descriptor>(i * 64 + __builtin_ctzll(w));
+					++x;
+				}
+			}
+			return;
+		}
+		std::vector<vertex_descriptor> found;
+		for(const interval& s : spans[u])
+			found.insert(found.end(), order.begin() + s.first, order.begin() + s.second + 1);
+		std::sort(found.begin(), found.end());
+		std::copy(found.begin(), found.end(), x);
+	}
+};
+
+// ------------------
+// transitive_closure
+// ------------------
+
+///
+/// Build the transitive closure of a directed, acyclic graph, with the range constructor of the graph
+/// The closure has an edge (u, v) for every path from u to another vertex v
+/// @tparam G - Graph Class Template, with a range constructor from an edge list and a number of vertices
+/// @param graph - a directed, acyclic graph
+/// @param index - the reachability_index of the graph
+/// @return the closure, with the vertices of the graph
+///
+template <typename G>
+G transitive_closure (const G& graph, const reachability_index<typename G::vertex_descriptor>& index)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	std::vector<std::pair<vertex_descriptor, vertex_descriptor> > ed;
+	std::vector<vertex_descriptor> reached;
+	for(std::size_t i = 0; i != num_vertices(graph); ++i)
+	{
+		const vertex_descriptor u = vertex(i, graph);
+		reached.clear();
+		index.descendants(u, std::back_inserter(reached));
+		for(vertex_descriptor v : reached)
+		{
+			if(v != u)
+				ed.push_back(std::make_pair(u, v));
+		}
+	}
+	return G(ed.begin(), ed.end(), num_vertices(graph));
+}
+
+///
+/// Build the transitive closure of a directed, acyclic graph, with the range constructor of the graph
+/// @tparam G - Graph Class Template, with a range constructor from an edge list and a number of vertices
+/// @param graph - a directed, acyclic graph
+/// @return the closure, with the vertices of the graph
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G>
+G transitive_closure (const G& graph)
+{
+	return transitive_closure(graph, reachability_index<typename G::vertex_descriptor>(graph));
+}
+
+#endif // ReachabilityIndex_h
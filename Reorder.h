@@ -0,0 +1,289 @@
+// ------------------------
+// projects/graph/Reorder.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------
+
+#ifndef Reorder_h
+#define Reorder_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // reverse, stable_sort
+#include <cstddef> // size_t
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "Graph.h" // Graph
+
+
+// ----------------
+// reorder_strategy
+// ----------------
+
+///
+/// The vertex orders that reorder computes
+/// reverse_cuthill_mckee: a breadth-first order of the graph with its edges taken in both directions, from a vertex of least degree in each component and through the neighbours of each vertex in ascending degree, reversed; it keeps the two ends of most edges close
+/// degree_descending: the vertices by descending degree, in and out, so the hubs that most edges point to share the first cache lines
+/// breadth_first_order: the order in which a breadth-first search along the edges discovers the vertices, from each undiscovered vertex in turn
+/// depth_first_order: the order in which a depth-first search along the edges discovers the vertices, from each undiscovered vertex in turn
+///
+enum reorder_strategy
+{
+	reverse_cuthill_mckee,
+	degree_descending,
+	breadth_first_order,
+	depth_first_order
+};
+
+// ------------------
+// vertex_permutation
+// ------------------
+
+///
+/// A relabeling of the vertices of a graph, in both directions
+/// to_new[v] is the new label of the vertex labeled v in the original graph, and to_old[w] is the original label of the vertex labeled w in the relabeled graph
+/// @tparam V - the vertex descriptor type
+///
+template <typename V>
+struct vertex_permutation
+{
+	std::vector<V> to_new;
+	std::vector<V> to_old;
+};
+
+// -------------------
+// symmetric_adjacency
+// -------------------
+
+///
+/// A helper function for reorder
+/// Build the neighbours of every vertex with the edges taken in both directions, without self-loops, in compressed sparse row form
+/// The neighbours of vertex v are neighbours[offsets[v]] through neighbours[offsets[v + 1] - 1], and may repeat where the graph has both (u, v) and (v, u)
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param offsets - receives the num_vertices(graph) + 1 row offsets
+/// @param neighbours - receives the neighbours
+///
+template <typename G>
+void symmetric_adjacency (const G& graph, std::vector<std::size_t>& offsets, std::vector<typename G::vertex_descriptor>& neighbours)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	const std::size_t n = num_vertices(graph);
+	offsets.assign(n + 1, 0);
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+		for(; av.first != av.second; ++av.first)
+		{
+			if(*av.first != vertex(i, graph))
+			{
+				++offsets[i + 1];
+				++offsets[*av.first + 1];
+			}
+		}
+	}
+	for(std::size_t i = 0; i != n; ++i)
+		offsets[i + 1] += offsets[i];
+
+	std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+	neighbours.resize(offsets[n]);
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		const vertex_descriptor u = vertex(i, graph);
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		for(; av.first != av.second; ++av.first)
+		{
+			if(*av.first != u)
+			{
+				neighbours[cursor[i]++] = *av.first;
+				neighbours[cursor[*av.first]++] = u;
+			}
+		}
+	}
+}
+
+// ------------
+// search_order
+// ------------
+
+///
+/// A helper function for reorder
+/// Find the order in which a breadth-first or depth-first search along the edges discovers the vertices
+/// Each vertex that no earlier search discovered starts a new search, in ascending order
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param breadth - true for a breadth-first search, false for a depth-first search
+/// @param order - receives the vertices in the order of discovery
+///
+template <typename G>
+void search_order (const G& graph, bool breadth, std::vector<typename G::vertex_descriptor>& order)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	const std::size_t n = num_vertices(graph);
+	std::vector<char> seen(n, 0);
+	std::vector<std::pair<adjacency_iterator, adjacency_iterator> > path;
+	order.clear();
+	order.reserve(n);
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		const vertex_descriptor r = vertex(i, graph);
+		if(seen[r])
+			continue;
+		seen[r] = 1;
+		order.push_back(r);
+		if(breadth)
+		{
+			for(std::size_t j = order.size() - 1; j != order.size(); ++j)
+			{
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(order[j], graph);
+				for(; av.first != av.second; ++av.first)
+				{
+					if(!seen[*av.first])
+					{
+						seen[*av.first] = 1;
+						order.push_back(*av.first);
+					}
+				}
+			}
+			continue;
+		}
+		path.push_back(adjacent_vertices(r, graph));
+		while(!path.empty())
+		{
+			std::pair<adjacency_iterator, adjacency_iterator>& av = path.back();
+			if(av.first == av.second)
+			{
+				path.pop_back();
+				continue;
+			}
+			const vertex_descriptor w = *av.first;
+			++av.first;
+			if(!seen[w])
+			{
+				seen[w] = 1;
+				order.push_back(w);
+				path.push_back(adjacent_vertices(w, graph));
+			}
+		}
+	}
+}
+
+// -------
+// reorder
+// -------
+
+///
+/// Find a relabeling of the vertices of a graph that places vertices that are used together close together
+/// A graph relabeled with relabel keeps the arrays that algorithms index by vertex, and the adjacency of a CSRGraph, in the order the traversals visit them, so more of each cache line they load is used
+/// Results computed on the relabeled graph are translated back through to_old
+/// Every strategy takes O(V + E) time, and reverse_cuthill_mckee and degree_descending also sort each vertex's neighbours or all the vertices by degree
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param strategy - the order to compute
+/// @return the relabeling, in both directions
+///
+template <typename G>
+vertex_permutation<typename G::vertex_descriptor> reorder (const G& graph, reorder_strategy strategy)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+
+	const std::size_t n = num_vertices(graph);
+	vertex_permutation<vertex_descriptor> p;
+	std::vector<vertex_descriptor>& order = p.to_old;
+
+	if(strategy == breadth_first_order || strategy == depth_first_order)
+		search_order(graph, strategy == breadth_first_order, order);
+	else
+	{
+		std::vector<std::size_t> offsets;
+		std::vector<vertex_descriptor> neighbours;
+		symmetric_adjacency(graph, offsets, neighbours);
+		auto degree = [&] (vertex_descriptor v) -> std::size_t
+		{
+			return offsets[v + 1] - offsets[v];
+		};
+		auto by_degree = [&] (vertex_descriptor u, vertex_descriptor v) -> bool
+		{
+			return degree(u) < degree(v);
+		};
+
+		order.reserve(n);
+		for(std::size_t i = 0; i != n; ++i)
+			order.push_back(vertex(i, graph));
+		if(strategy == degree_descending)
+			std::stable_sort(order.begin(), order.end(), [&] (vertex_descriptor u, vertex_descriptor v) -> bool
+			{
+				return degree(u) > degree(v);
+			});
+		else
+		{
+			// The roots are taken in ascending degree; each component is searched from the first of its vertices among them
+			std::vector<vertex_descriptor> roots;
+			roots.swap(order);
+			order.reserve(n);
+			std::stable_sort(roots.begin(), roots.end(), by_degree);
+			std::vector<char> seen(n, 0);
+			for(vertex_descriptor r : roots)
+			{
+				if(seen[r])
+					continue;
+				seen[r] = 1;
+				order.push_back(r);
+				for(std::size_t j = order.size() - 1; j != order.size(); ++j)
+				{
+					const std::size_t first = order.size();
+					for(std::size_t k = offsets[order[j]]; k != offsets[order[j] + 1]; ++k)
+					{
+						const vertex_descriptor w = neighbours[k];
+						if(!seen[w])
+						{
+							seen[w] = 1;
+							order.push_back(w);
+						}
+					}
+					std::stable_sort(order.begin() + first, order.end(), by_degree);
+				}
+			}
+			std::reverse(order.begin(), order.end());
+		}
+	}
+
+	p.to_new.resize(n);
+	for(std::size_t i = 0; i != n; ++i)
+		p.to_new[order[i]] = vertex(i, graph);
+	return p;
+}
+
+// -------
+// relabel
+// -------
+
+///
+/// Build a copy of a graph with its vertices relabeled, with the range constructor of the graph
+/// The edge (u, v) of the graph becomes the edge (p.to_new[u], p.to_new[v]) of the copy
+/// @tparam G - Graph Class Template, with a range constructor from an edge list and a number of vertices
+/// @param graph - a graph
+/// @param p - a relabeling of the vertices of the graph, as from reorder
+/// @return the relabeled graph
+///
+template <typename G>
+G relabel (const G& graph, const vertex_permutation<typename G::vertex_descriptor>& p)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::edge_iterator edge_iterator;
+
+	std::vector<std::pair<vertex_descriptor, vertex_descriptor> > ed;
+	ed.reserve(num_edges(graph));
+	std::pair<edge_iterator, edge_iterator> es = edges(graph);
+	for(; es.first != es.second; ++es.first)
+		ed.push_back(std::make_pair(p.to_new[source(*es.first, graph)], p.to_new[target(*es.first, graph)]));
+	return G(ed.begin(), ed.end(), num_vertices(graph));
+}
+
+#endif // Reorder_h
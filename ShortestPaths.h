@@ -0,0 +1,444 @@
+// ------------------------------
+// projects/graph/ShortestPaths.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef ShortestPaths_h
+#define ShortestPaths_h
+
+// --------
+// includes
+// --------
+#include <boost/throw_exception.hpp>
+#include <boost/graph/exception.hpp>
+#include <algorithm> // fill
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <iterator> // back_inserter
+#include <limits> // numeric_limits
+#include <type_traits> // conditional, is_integral, is_unsigned
+#include <utility> // make_pair, pair, swap
+#include <vector> // vector
+
+#include "EdgeProperty.h" // edge_property_map
+#include "Graph.h" // topological_sort
+
+
+// ---------
+// dary_heap
+// ---------
+
+///
+/// A min-heap of vertices by key, with decrease-key, in one array in which every entry has D children
+/// With D = 4 a sift down compares the four children of an entry, which share a cache line, and the heap is half as deep as a binary heap
+/// Each entry holds its key beside its vertex, so a comparison does not look up the key elsewhere, and a position per vertex finds the entry to decrease
+/// @tparam K - the key type
+/// @tparam V - the vertex descriptor type, an index below the number of vertices
+/// @tparam D - the number of children of each entry
+///
+template <typename K, typename V, std::size_t D = 4>
+class dary_heap
+{
+private:
+	// ----
+	// data
+	// ----
+	std::vector<std::pair<K, V> > heap;
+	std::vector<std::size_t> position; // The index of each vertex in heap, or absent
+
+	static const std::size_t absent = std::size_t(-1);
+
+private:
+	// -------
+	// sift_up
+	// -------
+
+	///
+	/// Move the entry at i toward the root until its parent's key is not greater
+	/// @param i - an index in heap
+	///
+	void sift_up (std::size_t i)
+	{
+		const std::pair<K, V> x = heap[i];
+		while(i != 0)
+		{
+			const std::size_t parent = (i - 1) / D;
+			if(!(x.first < heap[parent].first))
+				break;
+			heap[i] = heap[parent];
+			position[heap[i].second] = i;
+			i = parent;
+		}
+		heap[i] = x;
+		position[x.second] = i;
+	}
+
+	// ---------
+	// sift_down
+	// ---------
+
+	///
+	/// Move the entry at i toward the leaves until none of its children's keys is smaller
+	/// @param i - an index in heap
+	///
+	void sift_down (std::size_t i)
+	{
+		const std::pair<K, V> x = heap[i];
+		const std::size_t n = heap.size();
+		while(true)
+		{
+			const std::size_t first = D * i + 1;
+			if(first >= n)
+				break;
+			std::size_t least = first;
+			const std::size_t last = std::min(first + D, n);
+			for(std::size_t c = first + 1; c < last; ++c)
+			{
+				if(heap[c].first < heap[least].first)
+					least = c;
+			}
+			if(!(heap[least].first < x.first))
+				break;
+			heap[i] = heap[least];
+			position[heap[i].second] = i;
+			i = least;
+		}
+		heap[i] = x;
+		position[x.second] = i;
+	}
+
+public:
+	// -----------
+	// constructor
+	// -----------
+
+	///
+	/// Create an empty heap for the vertices below n
+	/// @param n - the number of vertices
+	///
+	explicit dary_heap (std::size_t n) : position(n, absent)
+	{
+	}
+
+	// -----
+	// empty
+	// -----
+
+	///
+	/// @return true if the heap has no vertices
+	///
+	bool empty () const
+	{
+		return heap.empty();
+	}
+
+	// ----
+	// push
+	// ----
+
+	///
+	/// Insert a vertex with a key, or lower the key of a vertex already in the heap
+	/// @param v - a vertex
+	/// @param k - its key, no greater than its key in the heap
+	///
+	void push (V v, const K& k)
+	{
+		std::size_t i = position[v];
+		if(i == absent)
+		{
+			i = heap.size();
+			heap.push_back(std::make_pair(k, v));
+		}
+		else
+		{
+			assert(!(heap[i].first < k));
+			heap[i].first = k;
+		}
+		sift_up(i);
+	}
+
+	// ---
+	// pop
+	// ---
+
+	///
+	/// Remove the vertex with the least key
+	/// @return the key and the vertex
+	///
+	std::pair<K, V> pop ()
+	{
+		assert(!empty());
+		const std::pair<K, V> top = heap.front();
+		position[top.second] = absent;
+		heap.front() = heap.back();
+		heap.pop_back();
+		if(!heap.empty())
+			sift_down(0);
+		return top;
+	}
+};
+
+template <typename K, typename V, std::size_t D>
+const std::size_t dary_heap<K, V, D>::absent;
+
+// ----------
+// radix_heap
+// ----------
+
+///
+/// A monotone min-heap of vertices by unsigned integer key: no key pushed is less than the last key popped
+/// A key goes to the bucket of the highest bit in which it differs from the last key popped, so a pop empties bucket 0 and otherwise redistributes only the first nonempty bucket
+/// Each entry moves to a lower bucket at most once per bit of the key, so a push and its pop take O(bits) time and only stream through vectors
+/// It has no decrease-key: a vertex is pushed again with its lower key, and the caller skips the entries whose key is no longer the vertex's
+/// @tparam K - the key type, an unsigned integer
+/// @tparam V - the vertex descriptor type
+///
+template <typename K, typename V>
+class radix_heap
+{
+private:
+	// ----
+	// data
+	// ----
+	static const std::size_t bits = std::numeric_limits<K>::digits;
+	std::vector<std::pair<K, V> > buckets[bits + 1];
+	K last; // The last key popped
+	std::size_t count;
+
+private:
+	// ------
+	// bucket
+	// ------
+
+	///
+	/// @param k - a key no less than last
+	/// @return 0 if the key is last, and otherwise one more than the index of the highest bit in which it differs from last
+	///
+	std::size_t bucket (const K& k) const
+	{
+		K x = k ^ last;
+		std::size_t b = 0;
+		while(x != 0)
+		{
+			x >>= 1;
+			++b;
+		}
+		return b;
+	}
+
+public:
+	// -----------
+	// constructor
+	// -----------
+
+	///
+	/// Create an empty heap, with the same signature as dary_heap
+	/// @param n - the number of vertices, which a radix_heap does not need
+	///
+	explicit radix_heap (std::size_t = 0) : last(0), count(0)
+	{
+		static_assert(std::is_integral<K>::value && std::is_unsigned<K>::value, "radix_heap needs unsigned integer keys");
+	}
+
+	// -----
+	// empty
+	// -----
+
+	///
+	/// @return true if the heap has no entries
+	///
+	bool empty () const
+	{
+		return count == 0;
+	}
+
+	// ----
+	// push
+	// ----
+
+	///
+	/// Insert a vertex with a key
+	/// @param v - a vertex
+	/// @param k - its key, no less than the last key popped
+	///
+	void push (V v, const K& k)
+	{
+		assert(!(k < last));
+		buckets[bucket(k)].push_back(std::make_pair(k, v));
+		++count;
+	}
+
+	// ---
+	// pop
+	// ---
+
+	///
+	/// Remove an entry with the least key
+	/// @return the key and the vertex
+	///
+	std::pair<K, V> pop ()
+	{
+		assert(!empty());
+		if(buckets[0].empty())
+		{
+			std::size_t i = 1;
+			while(buckets[i].empty())
+				++i;
+			last = buckets[i].front().first;
+			for(const std::pair<K, V>& x : buckets[i])
+			{
+				if(x.first < last)
+					last = x.first;
+			}
+			for(const std::pair<K, V>& x : buckets[i])
+				buckets[bucket(x.first)].push_back(x);
+			buckets[i].clear();
+		}
+		const std::pair<K, V> top = buckets[0].back();
+		buckets[0].pop_back();
+		--count;
+		return top;
+	}
+};
+
+template <typename K, typename V>
+const std::size_t radix_heap<K, V>::bits;
+
+// -----------------------
+// dijkstra_shortest_paths
+// -----------------------
+
+///
+/// best-first traversal
+/// Find the length of a shortest path from the source to every vertex, along edges with nonnegative weights
+/// The frontier is a radix_heap for unsigned integer weights, and a 4-ary dary_heap with decrease-key for any other weight type
+/// The weights of the edges from a vertex are read beside its adjacent vertices, from one row of the map
+/// @tparam G - Graph Class Template
+/// @tparam W - the weight type
+/// @tparam RI - Random Access Iterator Template, whose value_type is W
+/// @tparam PI - Random Access Iterator Template, whose value_type is a vertex descriptor
+/// @param graph - a graph
+/// @param weight - the weight of every edge of the graph
+/// @param s - the source
+/// @param distance - receives the length of a shortest path to each vertex, distance[v] for vertex v, or std::numeric_limits<W>::max() if the source does not reach it
+/// @param predecessor - receives the vertex before each vertex on its shortest path; the source and the vertices it does not reach are their own predecessors
+/// @throws Boost's negative_edge exception if an edge that the search reaches has a negative weight
+///
+template <typename G, typename W, typename RI, typename PI>
+void dijkstra_shortest_paths (const G& graph, const edge_property_map<W>& weight, typename G::vertex_descriptor s, RI distance, PI predecessor)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef typename edge_property_map<W>::const_iterator weight_iterator;
+	typedef typename std::conditional<std::is_integral<W>::value && std::is_unsigned<W>::value, radix_heap<W, vertex_descriptor>, dary_heap<W, vertex_descriptor> >::type heap_type;
+
+	const std::size_t n = num_vertices(graph);
+	const W infinity = std::numeric_limits<W>::max();
+	std::fill(distance, distance + n, infinity);
+	for(std::size_t i = 0; i != n; ++i)
+		predecessor[i] = vertex(i, graph);
+
+	heap_type frontier(n);
+	distance[s] = W();
+	frontier.push(s, W());
+	while(!frontier.empty())
+	{
+		const std::pair<W, vertex_descriptor> top = frontier.pop();
+		const vertex_descriptor u = top.second;
+		if(distance[u] < top.first)
+			continue;
+
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		weight_iterator w = weight.row(u).first;
+		for(; av.first != av.second; ++av.first, ++w)
+		{
+			if(*w < W())
+				boost::throw_exception(boost::negative_edge());
+			const W d = top.first + *w;
+			const vertex_descriptor v = *av.first;
+			if(d < distance[v])
+			{
+				distance[v] = d;
+				predecessor[v] = u;
+				frontier.push(v, d);
+			}
+		}
+	}
+}
+
+///
+/// Find the length of a shortest path from the source to every vertex, along edges with nonnegative weights, without the predecessors
+/// @tparam G - Graph Class Template
+/// @tparam W - the weight type
+/// @tparam RI - Random Access Iterator Template, whose value_type is W
+/// @param graph - a graph
+/// @param weight - the weight of every edge of the graph
+/// @param s - the source
+/// @param distance - receives the length of a shortest path to each vertex, or std::numeric_limits<W>::max() if the source does not reach it
+/// @throws Boost's negative_edge exception if an edge that the search reaches has a negative weight
+///
+template <typename G, typename W, typename RI>
+void dijkstra_shortest_paths (const G& graph, const edge_property_map<W>& weight, typename G::vertex_descriptor s, RI distance)
+{
+	std::vector<typename G::vertex_descriptor> predecessor(num_vertices(graph));
+	dijkstra_shortest_paths(graph, weight, s, distance, predecessor.begin());
+}
+
+// ------------------
+// dag_shortest_paths
+// ------------------
+
+///
+/// Find the length of a shortest path from the source to every vertex of a directed, acyclic graph, along edges with any weights
+/// The vertices are relaxed once each, in the topological order from topological_sort, so no heap is needed and the search takes O(V + E) time
+/// @tparam G - Graph Class Template
+/// @tparam W - the weight type
+/// @tparam RI - Random Access Iterator Template, whose value_type is W
+/// @tparam PI - Random Access Iterator Template, whose value_type is a vertex descriptor
+/// @param graph - a directed, acyclic graph
+/// @param weight - the weight of every edge of the graph
+/// @param s - the source
+/// @param distance - receives the length of a shortest path to each vertex, distance[v] for vertex v, or std::numeric_limits<W>::max() if the source does not reach it
+/// @param predecessor - receives the vertex before each vertex on its shortest path; the source and the vertices it does not reach are their own predecessors
+/// @throws Boost's not_a_dag exception if the graph has a cycle
+///
+template <typename G, typename W, typename RI, typename PI>
+void dag_shortest_paths (const G& graph, const edge_property_map<W>& weight, typename G::vertex_descriptor s, RI distance, PI predecessor)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef typename edge_property_map<W>::const_iterator weight_iterator;
+
+	const std::size_t n = num_vertices(graph);
+	std::vector<vertex_descriptor> order;
+	order.reserve(n);
+	topological_sort(graph, std::back_inserter(order));
+
+	const W infinity = std::numeric_limits<W>::max();
+	std::fill(distance, distance + n, infinity);
+	for(std::size_t i = 0; i != n; ++i)
+		predecessor[i] = vertex(i, graph);
+	distance[s] = W();
+
+	// topological_sort writes every vertex after the vertices it has edges to, so the order is walked from the back
+	for(typename std::vector<vertex_descriptor>::reverse_iterator p = order.rbegin(); p != order.rend(); ++p)
+	{
+		const vertex_descriptor u = *p;
+		if(distance[u] == infinity)
+			continue;
+		std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, graph);
+		weight_iterator w = weight.row(u).first;
+		for(; av.first != av.second; ++av.first, ++w)
+		{
+			const W d = distance[u] + *w;
+			if(d < distance[*av.first])
+			{
+				distance[*av.first] = d;
+				predecessor[*av.first] = u;
+			}
+		}
+	}
+}
+
+#endif // ShortestPaths_h
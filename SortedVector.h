@@ -0,0 +1,252 @@
+// -----------------------------
+// projects/graph/SortedVector.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef SortedVector_h
+#define SortedVector_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // lower_bound, sort, unique
+#include <cstddef> // size_t
+#include <memory> // allocator
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+
+// -------------
+// sorted_vector
+// -------------
+
+///
+/// A set of unique values kept in ascending order in one contiguous array
+/// It has the interface of std::set that the graphs use, but a value costs only its own size, and a scan reads consecutive memory
+/// A lookup is a binary search, and an insertion shifts the larger values, so it is O(size) unless the value is the new largest
+/// @tparam T - the value type, which is less-than comparable
+/// @tparam A - the allocator of the array
+///
+template <typename T, typename A = std::allocator<T> >
+class sorted_vector
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef T key_type;
+	typedef T value_type;
+	typedef A allocator_type;
+	typedef std::size_t size_type;
+
+	typedef typename std::vector<T, A>::const_iterator const_iterator;
+	typedef const_iterator iterator;
+
+private:
+	// ----
+	// data
+	// ----
+	std::vector<T, A> values;
+
+public:
+	// -----------
+	// operator ==
+	// -----------
+
+	/**
+	* equal operator
+	* @param lhs - the left hand side sorted_vector
+	* @param rhs - the right hand side sorted_vector
+	* @return true if both hold the same values
+	*/
+	friend bool operator == (const sorted_vector& lhs, const sorted_vector& rhs)
+	{
+		return lhs.values == rhs.values;
+	}
+
+	/**
+	* not equal operator
+	* @param lhs - the left hand side sorted_vector
+	* @param rhs - the right hand side sorted_vector
+	* @return true if the values differ
+	*/
+	friend bool operator != (const sorted_vector& lhs, const sorted_vector& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Default Constructor - Empty set
+	/// @param a - the allocator of the array
+	///
+	explicit sorted_vector (const allocator_type& a = allocator_type()) : values(a)
+	{}
+
+	///
+	/// Range Constructor - the distinct values of a range
+	/// @tparam II - Input Iterator Template
+	/// @param b - the beginning of the values
+	/// @param e - the end of the values
+	/// @param a - the allocator of the array
+	///
+	template <typename II>
+	sorted_vector (II b, II e, const allocator_type& a = allocator_type()) : values(b, e, a)
+	{
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+	}
+
+	///
+	/// Allocator-Extended Copy Constructor
+	/// @param that - a sorted_vector
+	/// @param a - the allocator of the copy
+	///
+	sorted_vector (const sorted_vector& that, const allocator_type& a) : values(that.values.begin(), that.values.end(), a)
+	{}
+
+	// Default copy, move, destructor, and copy assignment
+
+	// -----
+	// begin
+	// -----
+
+	///
+	/// @return an iterator to the smallest value
+	///
+	const_iterator begin () const
+	{
+		return values.begin();
+	}
+
+	// ---
+	// end
+	// ---
+
+	///
+	/// @return an iterator past the largest value
+	///
+	const_iterator end () const
+	{
+		return values.end();
+	}
+
+	// ----
+	// size
+	// ----
+
+	///
+	/// @return the number of values
+	///
+	size_type size () const
+	{
+		return values.size();
+	}
+
+	// -----
+	// empty
+	// -----
+
+	///
+	/// @return true if there are no values
+	///
+	bool empty () const
+	{
+		return values.empty();
+	}
+
+	// ----
+	// find
+	// ----
+
+	///
+	/// @param v - a value
+	/// @return an iterator to v, or end() if v is not in the set
+	///
+	const_iterator find (const value_type& v) const
+	{
+		const_iterator p = std::lower_bound(values.begin(), values.end(), v);
+		return (p != values.end() && !(v < *p)) ? p : values.end();
+	}
+
+	// ------
+	// insert
+	// ------
+
+	///
+	/// Add a value if it is not in the set yet
+	/// @param v - a value
+	/// @return an iterator to v, and true if v was inserted
+	///
+	std::pair<const_iterator, bool> insert (const value_type& v)
+	{
+		typename std::vector<T, A>::iterator p = std::lower_bound(values.begin(), values.end(), v);
+		if(p != values.end() && !(v < *p))
+			return std::make_pair(const_iterator(p), false);
+		return std::make_pair(const_iterator(values.insert(p, v)), true);
+	}
+
+	///
+	/// Add a value if it is not in the set yet, without a search if it belongs right before the hint
+	/// Appending in ascending order with end() as the hint is amortized O(1)
+	/// @param hint - an iterator to the position that v probably belongs before
+	/// @param v - a value
+	/// @return an iterator to v
+	///
+	const_iterator insert (const_iterator hint, const value_type& v)
+	{
+		if((hint == values.begin() || *(hint - 1) < v) && (hint == values.end() || v < *hint))
+			return values.insert(values.begin() + (hint - values.begin()), v);
+		return insert(v).first;
+	}
+
+	// -----
+	// erase
+	// -----
+
+	///
+	/// Remove a value
+	/// @param v - a value
+	/// @return the number of values removed, 0 or 1
+	///
+	size_type erase (const value_type& v)
+	{
+		const_iterator p = find(v);
+		if(p == values.end())
+			return 0;
+		values.erase(values.begin() + (p - values.begin()));
+		return 1;
+	}
+
+	// -----
+	// clear
+	// -----
+
+	///
+	/// Remove every value
+	///
+	void clear ()
+	{
+		values.clear();
+	}
+
+	// -------
+	// reserve
+	// -------
+
+	///
+	/// Allocate the array for at least n values, so the next insertions up to n values do not reallocate
+	/// @param n - a number of values
+	///
+	void reserve (size_type n)
+	{
+		values.reserve(n);
+	}
+};
+
+#endif // SortedVector_h
@@ -0,0 +1,565 @@
+// ---------------------------------
+// projects/graph/StrongComponents.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------------
+
+#ifndef StrongComponents_h
+#define StrongComponents_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // max, min
+#include <atomic> // atomic
+#include <cstddef> // size_t
+#include <iterator> // distance
+#include <limits> // numeric_limits
+#include <mutex> // lock_guard, mutex
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "Graph.h" // Graph, topological_levels, transpose_adjacency
+#include "CSRGraph.h" // CSRGraph
+#include "ThreadPool.h" // ThreadPool
+
+
+// ---------
+// constants
+// ---------
+
+const std::size_t scc_grain = 1024; // the smallest frontier that is expanded by more than one thread
+const std::size_t scc_serial_vertices = 1 << 14; // the number of remaining vertices below which Tarjan's algorithm finishes the parallel search
+const std::size_t scc_min_progress = 16; // a coloring round must finish at least 1 / scc_min_progress of the remaining vertices, or Tarjan's algorithm finishes them
+const std::size_t scc_color_work = 8; // a coloring round may raise colors at most scc_color_work times per remaining vertex, or Tarjan's algorithm finishes them
+
+// -----------
+// find_strong
+// -----------
+
+///
+/// A helper function for the strongly_connected_components functions
+/// This function executes Tarjan's algorithm as one iterative depth-first search, so its depth is not limited by the thread's stack size
+/// Each vertex gets a discovery index and a low link, the smallest index on the search stack that it reaches
+/// A vertex whose low link is its own index is the root of a component, which is the part of the search stack above it
+/// Components are emitted in reverse topological order: a component is emitted after every component it has an edge to
+/// @tparam G - Graph Class Template
+/// @tparam P - Predicate Template, called as skip(v), true for the vertices that the search leaves out
+/// @tparam F - Function Template, called as emit(b, e) with the vertices of each component, the root first
+/// @param graph - a graph
+/// @param skip - the vertices to leave out, as if they and their edges were not in the graph
+/// @param emit - the function that receives the components
+///
+template <typename G, typename P, typename F>
+void find_strong (const G& graph, P skip, F emit)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	const std::size_t n = num_vertices(graph);
+	const std::size_t unvisited = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> index(n, unvisited);
+	std::vector<std::size_t> low(n);
+	std::vector<char> stacked(n, 0);
+	std::vector<vertex_descriptor> stack;
+	std::vector<std::pair<vertex_descriptor, std::pair<adjacency_iterator, adjacency_iterator> > > path;
+	std::size_t next = 0;
+
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		const vertex_descriptor r = vertex(i, graph);
+		if(index[r] != unvisited || skip(r))
+			continue;
+
+		index[r] = low[r] = next++;
+		stacked[r] = 1;
+		stack.push_back(r);
+		path.push_back(std::make_pair(r, adjacent_vertices(r, graph)));
+		while(!path.empty())
+		{
+			const vertex_descriptor u = path.back().first;
+			std::pair<adjacency_iterator, adjacency_iterator>& av = path.back().second;
+			if(av.first != av.second)
+			{
+				const vertex_descriptor w = *av.first;
+				++av.first;
+				if(index[w] == unvisited)
+				{
+					if(!skip(w))
+					{
+						index[w] = low[w] = next++;
+						stacked[w] = 1;
+						stack.push_back(w);
+						path.push_back(std::make_pair(w, adjacent_vertices(w, graph)));
+					}
+				}
+				else if(stacked[w])
+					low[u] = std::min(low[u], index[w]);
+				continue;
+			}
+
+			// u is finished: pass its low link to its parent, and pop its component if it is a root
+			path.pop_back();
+			if(!path.empty())
+				low[path.back().first] = std::min(low[path.back().first], low[u]);
+			if(low[u] == index[u])
+			{
+				std::size_t b = stack.size();
+				do
+					--b;
+				while(stack[b] != u);
+				for(std::size_t j = b; j != stack.size(); ++j)
+					stacked[stack[j]] = 0;
+				emit(stack.begin() + b, stack.end());
+				stack.resize(b);
+			}
+		}
+	}
+}
+
+// -----------------------------
+// strongly_connected_components
+// -----------------------------
+
+///
+/// Partition the vertices of the graph into strongly connected components: two vertices are in the same component if each has a path to the other
+/// Tarjan's algorithm, with an explicit stack
+/// The components are numbered in reverse topological order, like the output of topological_sort: every edge between two components goes from a higher to a lower number
+/// An acyclic graph has one component per vertex, and a vertex is in a cycle exactly when its component has another vertex or the vertex has an edge to itself
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - receives the component number of each vertex, component[v] for vertex v
+/// @return the number of components
+///
+template <typename G, typename RI>
+std::size_t strongly_connected_components (const G& graph, RI component)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename std::vector<vertex_descriptor>::iterator iterator;
+
+	std::size_t count = 0;
+	find_strong(graph, [] (vertex_descriptor) {return false;}, [&] (iterator b, iterator e)
+	{
+		for(; b != e; ++b)
+			component[*b] = count;
+		++count;
+	});
+	return count;
+}
+
+// ---------------
+// condensed_edges
+// ---------------
+
+///
+/// A helper function for the condensation functions
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - the component number of each vertex
+/// @param pool - if not null, the threads that read the edges
+/// @return the edges of the graph between different components, as pairs of component numbers, possibly repeated
+///
+template <typename G, typename RI>
+std::vector<std::pair<std::size_t, std::size_t> > condensed_edges (const G& graph, RI component, ThreadPool* pool)
+{
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	std::mutex guard;
+	auto gather = [&] (std::size_t b, std::size_t e)
+	{
+		std::vector<std::pair<std::size_t, std::size_t> > found;
+		for(std::size_t i = b; i < e; ++i)
+		{
+			const std::size_t c = component[i];
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			for(; av.first != av.second; ++av.first)
+			{
+				if(component[*av.first] != c)
+					found.push_back(std::make_pair(c, static_cast<std::size_t>(component[*av.first])));
+			}
+		}
+		std::lock_guard<std::mutex> locked(guard);
+		ed.insert(ed.end(), found.begin(), found.end());
+	};
+	if(pool != nullptr)
+		pool->parallel_for(0, num_vertices(graph), gather);
+	else
+		gather(0, num_vertices(graph));
+	return ed;
+}
+
+// ------------
+// condensation
+// ------------
+
+///
+/// Build the condensation of a graph: the graph with one vertex per strongly connected component, and an edge c -> d when some edge of the graph goes from component c to component d
+/// The condensation is acyclic, so its topological order is an order to process the components in
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - the component number of each vertex, from strongly_connected_components
+/// @param count - the number of components
+/// @return the condensation, whose vertex c is the component numbered c
+///
+template <typename G, typename RI>
+Graph condensation (const G& graph, RI component, std::size_t count)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = condensed_edges(graph, component, static_cast<ThreadPool*>(nullptr));
+	return Graph(ed.begin(), ed.end(), count);
+}
+
+///
+/// Build the condensation of a graph, reading the edges and sorting the condensed edges with every thread of the pool
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - the component number of each vertex, from strongly_connected_components
+/// @param count - the number of components
+/// @param pool - the threads that build the condensation
+/// @return the condensation, whose vertex c is the component numbered c
+///
+template <typename G, typename RI>
+Graph condensation (const G& graph, RI component, std::size_t count, ThreadPool& pool)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = condensed_edges(graph, component, &pool);
+	return Graph(ed.begin(), ed.end(), count, pool);
+}
+
+// ---------------
+// expand_frontier
+// ---------------
+
+///
+/// A helper function for the parallel_strongly_connected_components functions
+/// Replace a frontier of a breadth-first search with the vertices that its vertices discover
+/// Each chunk gathers its vertices locally and appends them to the next frontier once
+/// A small frontier is expanded by the calling thread alone
+/// @tparam V - the vertex descriptor type
+/// @tparam F - Function Template, called as visit(v, found) for each vertex v of the frontier, appending the vertices it discovers to found
+/// @param pool - the threads that expand the frontier
+/// @param frontier - the vertices of the frontier, replaced by the next frontier
+/// @param visit - the function that expands one vertex
+///
+template <typename V, typename F>
+void expand_frontier (ThreadPool& pool, std::vector<V>& frontier, F visit)
+{
+	std::vector<V> next;
+	std::mutex guard;
+	pool.parallel_for(0, frontier.size(), [&] (std::size_t b, std::size_t e)
+	{
+		std::vector<V> found;
+		for(std::size_t i = b; i < e; ++i)
+			visit(frontier[i], found);
+		std::lock_guard<std::mutex> locked(guard);
+		next.insert(next.end(), found.begin(), found.end());
+	}, std::max(scc_grain, frontier.size() / (4 * pool.size())));
+	frontier.swap(next);
+}
+
+// ----------------
+// collect_vertices
+// ----------------
+
+///
+/// A helper function for the parallel_strongly_connected_components functions
+/// @tparam G - Graph Class Template
+/// @tparam P - Predicate Template, called once as keep(v) for each vertex v
+/// @param graph - a graph
+/// @param keep - the vertices to collect
+/// @param pool - the threads that test the vertices
+/// @return the vertices that satisfy keep, in no particular order
+///
+template <typename G, typename P>
+std::vector<typename G::vertex_descriptor> collect_vertices (const G& graph, P keep, ThreadPool& pool)
+{
+	std::vector<typename G::vertex_descriptor> kept;
+	std::mutex guard;
+	pool.parallel_for(0, num_vertices(graph), [&] (std::size_t b, std::size_t e)
+	{
+		std::vector<typename G::vertex_descriptor> found;
+		for(std::size_t i = b; i < e; ++i)
+		{
+			if(keep(vertex(i, graph)))
+				found.push_back(vertex(i, graph));
+		}
+		std::lock_guard<std::mutex> locked(guard);
+		kept.insert(kept.end(), found.begin(), found.end());
+	});
+	return kept;
+}
+
+// --------------------------------------
+// parallel_strongly_connected_components
+// --------------------------------------
+
+///
+/// Partition the vertices of the graph into strongly connected components with every thread of the pool
+/// The Multistep method, whose steps each remove whole components from the search:
+/// 1. Trimming: a vertex without incoming or outgoing edges among the remaining vertices is a component by itself, and removing it can trim its neighbors
+/// 2. Forward-backward: the vertices reached both forward and backward from a pivot of high degree form its component, which is usually the giant component
+/// 3. Coloring: every remaining vertex takes the largest vertex number that reaches it, and each vertex that keeps its own number collects its component with a backward search among the vertices of its color
+/// 4. Once few vertices remain, or a coloring round makes little progress or too much work, Tarjan's algorithm finishes them
+/// Every search is a breadth-first search whose frontiers are expanded in parallel, and vertices are claimed with atomic operations
+/// The backward searches read a transposed copy of the edges, built in parallel, which costs one vertex descriptor per edge
+/// The components are numbered in reverse topological order of the condensation, each level of it in a fixed order, so the numbering does not depend on the thread schedule,
+/// but it is not always the numbering of strongly_connected_components
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - receives the component number of each vertex, component[v] for vertex v
+/// @param pool - the threads that run the search
+/// @return the number of components
+///
+template <typename G, typename RI>
+std::size_t parallel_strongly_connected_components (const G& graph, RI component, ThreadPool& pool)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	typedef std::vector<vertex_descriptor> frontier_type;
+
+	const std::size_t n = num_vertices(graph);
+	const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+	// The transposed edges, and the degrees of each vertex among the remaining vertices
+	std::vector<std::size_t> in_offsets;
+	std::vector<vertex_descriptor> in_sources;
+	transpose_adjacency(graph, in_offsets, in_sources, pool);
+	std::vector<std::atomic<std::size_t> > indegree(n);
+	std::vector<std::atomic<std::size_t> > outdegree(n);
+	std::vector<std::atomic<std::size_t> > label(n); // the representative vertex of the component of each vertex, or none while it remains
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+		{
+			indegree[i].store(in_offsets[i + 1] - in_offsets[i], std::memory_order_relaxed);
+			label[i].store(none, std::memory_order_relaxed);
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(vertex(i, graph), graph);
+			outdegree[i].store(std::distance(av.first, av.second), std::memory_order_relaxed);
+		}
+	});
+
+	// A vertex joins a component by the one successful claim of its label
+	auto claim = [&] (vertex_descriptor v, std::size_t representative) -> bool
+	{
+		std::size_t expected = none;
+		return label[v].load(std::memory_order_relaxed) == none && label[v].compare_exchange_strong(expected, representative, std::memory_order_relaxed);
+	};
+	auto remaining = [&] (vertex_descriptor v) -> bool
+	{
+		return label[v].load(std::memory_order_relaxed) == none;
+	};
+	std::size_t left = n;
+
+	// 1. Trimming
+	{
+		frontier_type frontier = collect_vertices(graph, [&] (vertex_descriptor v)
+		{
+			return (indegree[v].load(std::memory_order_relaxed) == 0 || outdegree[v].load(std::memory_order_relaxed) == 0) && claim(v, v);
+		}, pool);
+		while(!frontier.empty())
+		{
+			left -= frontier.size();
+			expand_frontier(pool, frontier, [&] (vertex_descriptor v, frontier_type& found)
+			{
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+				for(; av.first != av.second; ++av.first)
+				{
+					const vertex_descriptor w = *av.first;
+					if(remaining(w) && indegree[w].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(w, w))
+						found.push_back(w);
+				}
+				for(std::size_t j = in_offsets[v]; j != in_offsets[v + 1]; ++j)
+				{
+					const vertex_descriptor u = in_sources[j];
+					if(remaining(u) && outdegree[u].fetch_sub(1, std::memory_order_relaxed) == 1 && claim(u, u))
+						found.push_back(u);
+				}
+			});
+		}
+	}
+
+	// 2. Forward-backward from the remaining vertex with the most paths through it, by the product of its degrees
+	std::vector<std::atomic<char> > marked(n);
+	if(left > scc_serial_vertices)
+	{
+		std::pair<std::size_t, std::size_t> pivot(0, none);
+		std::mutex guard;
+		pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+		{
+			std::pair<std::size_t, std::size_t> best(0, none);
+			for(std::size_t i = b; i < e; ++i)
+			{
+				marked[i].store(0, std::memory_order_relaxed);
+				const std::size_t paths = indegree[i].load(std::memory_order_relaxed) * outdegree[i].load(std::memory_order_relaxed);
+				if(remaining(i) && (best.second == none || paths > best.first))
+					best = std::make_pair(paths, i);
+			}
+			std::lock_guard<std::mutex> locked(guard);
+			if(best.second != none && (pivot.second == none || best.first > pivot.first || (best.first == pivot.first && best.second < pivot.second)))
+				pivot = best;
+		});
+
+		const vertex_descriptor p = vertex(pivot.second, graph);
+		frontier_type frontier(1, p);
+		marked[p].store(1, std::memory_order_relaxed);
+		while(!frontier.empty())
+		{
+			expand_frontier(pool, frontier, [&] (vertex_descriptor v, frontier_type& found)
+			{
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+				for(; av.first != av.second; ++av.first)
+				{
+					const vertex_descriptor w = *av.first;
+					if(remaining(w) && marked[w].exchange(1, std::memory_order_relaxed) == 0)
+						found.push_back(w);
+				}
+			});
+		}
+
+		// The backward search stays among the vertices reached forward, so it collects exactly the component of the pivot
+		claim(p, pivot.second);
+		frontier.assign(1, p);
+		while(!frontier.empty())
+		{
+			left -= frontier.size();
+			expand_frontier(pool, frontier, [&] (vertex_descriptor v, frontier_type& found)
+			{
+				for(std::size_t j = in_offsets[v]; j != in_offsets[v + 1]; ++j)
+				{
+					const vertex_descriptor u = in_sources[j];
+					if(marked[u].load(std::memory_order_relaxed) && claim(u, pivot.second))
+						found.push_back(u);
+				}
+			});
+		}
+	}
+
+	// 3. Coloring
+	std::vector<std::atomic<std::size_t> > color(n);
+	while(left > scc_serial_vertices)
+	{
+		frontier_type frontier = collect_vertices(graph, remaining, pool);
+		pool.parallel_for(0, frontier.size(), [&] (std::size_t b, std::size_t e)
+		{
+			for(std::size_t i = b; i < e; ++i)
+			{
+				color[frontier[i]].store(frontier[i], std::memory_order_relaxed);
+				marked[frontier[i]].store(0, std::memory_order_relaxed);
+			}
+		});
+
+		// Push the larger colors forward until no color changes; a raised vertex is queued once per round by its mark
+		// A long path against the vertex numbers raises each of its vertices once per larger color, so a round that does too much work is abandoned
+		std::size_t work = 0;
+		while(!frontier.empty() && work <= scc_color_work * left)
+		{
+			work += frontier.size();
+			expand_frontier(pool, frontier, [&] (vertex_descriptor v, frontier_type& found)
+			{
+				marked[v].store(0, std::memory_order_relaxed);
+				const std::size_t c = color[v].load(std::memory_order_relaxed);
+				std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+				for(; av.first != av.second; ++av.first)
+				{
+					const vertex_descriptor w = *av.first;
+					if(!remaining(w))
+						continue;
+					std::size_t old = color[w].load(std::memory_order_relaxed);
+					while(old < c && !color[w].compare_exchange_weak(old, c, std::memory_order_relaxed))
+					{}
+					if(old < c && marked[w].exchange(1, std::memory_order_relaxed) == 0)
+						found.push_back(w);
+				}
+			});
+		}
+
+		if(!frontier.empty())
+			break;
+
+		// Each vertex that kept its own color is the root of a component, made of the vertices of its color that reach it
+		frontier = collect_vertices(graph, [&] (vertex_descriptor v)
+		{
+			return color[v].load(std::memory_order_relaxed) == v && claim(v, v);
+		}, pool);
+		const std::size_t before = left;
+		while(!frontier.empty())
+		{
+			left -= frontier.size();
+			expand_frontier(pool, frontier, [&] (vertex_descriptor v, frontier_type& found)
+			{
+				const std::size_t c = color[v].load(std::memory_order_relaxed);
+				for(std::size_t j = in_offsets[v]; j != in_offsets[v + 1]; ++j)
+				{
+					const vertex_descriptor u = in_sources[j];
+					if(color[u].load(std::memory_order_relaxed) == c && claim(u, c))
+						found.push_back(u);
+				}
+			});
+		}
+		if((before - left) * scc_min_progress < before)
+			break;
+	}
+
+	// 4. Tarjan's algorithm on the remaining vertices
+	if(left != 0)
+	{
+		typedef typename frontier_type::iterator iterator;
+		find_strong(graph, [&] (vertex_descriptor v) {return !remaining(v);}, [&] (iterator b, iterator e)
+		{
+			const std::size_t representative = *b;
+			for(; b != e; ++b)
+				label[*b].store(representative, std::memory_order_relaxed);
+		});
+	}
+
+	// Number the components by the rank of their representatives, then by the reverse topological levels of the condensation
+	std::vector<std::size_t> rank(n);
+	std::size_t count = 0;
+	for(std::size_t i = 0; i != n; ++i)
+	{
+		if(label[i].load(std::memory_order_relaxed) == i)
+			rank[i] = count++;
+	}
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+			component[i] = rank[label[i].load(std::memory_order_relaxed)];
+	});
+
+	std::vector<std::pair<std::size_t, std::size_t> > ed = condensed_edges(graph, component, &pool);
+	const CSRGraph dag(ed.begin(), ed.end(), count, pool);
+	std::vector<std::vector<CSRGraph::vertex_descriptor> > levels = topological_levels(dag, pool);
+	std::size_t number = 0;
+	for(std::size_t d = levels.size(); d != 0; --d)
+	{
+		for(CSRGraph::vertex_descriptor c : levels[d - 1])
+			rank[c] = number++;
+	}
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+			component[i] = rank[component[i]];
+	});
+	return count;
+}
+
+///
+/// Partition the vertices of the graph into strongly connected components, with one thread per hardware thread
+/// @tparam G - Graph Class Template
+/// @tparam RI - Random Access Iterator Template
+/// @param graph - a graph
+/// @param component - receives the component number of each vertex, component[v] for vertex v
+/// @return the number of components
+///
+template <typename G, typename RI>
+std::size_t parallel_strongly_connected_components (const G& graph, RI component)
+{
+	ThreadPool pool;
+	return parallel_strongly_connected_components(graph, component, pool);
+}
+
+#endif // StrongComponents_h
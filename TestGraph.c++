@@ -26,6 +26,8 @@ To test the program:
 #include <stddef.h>
 #include <iostream> // cout, endl
 #include <iterator> // ostream_iterator
+#include <numeric>  // accumulate
+#include <random>   // mt19937
 #include <sstream>  // ostringstream
 #include <utility>  // pair
 
@@ -36,11 +38,26 @@ To test the program:
 #include "gtest/gtest.h"
 
 #include "Graph.h"
+#include "BreadthFirstSearch.h"
+#include "CSRGraph.h"
+#include "ConcurrentGraph.h"
+#include "CriticalPath.h"
+#include "EdgeProperty.h"
+#include "GraphReader.h"
+#include "GraphTrace.h"
+#include "ReachabilityIndex.h"
+#include "GraphSnapshot.h"
+#include "Reorder.h"
+#include "ShortestPaths.h"
+#include "StrongComponents.h"
+#include "TopologicalOrder.h"
+#include "TriangleCount.h"
 
 using namespace std;
 
 typedef boost::error_info<struct tag_errmsg, std::string> errmsg_info; 
-typedef testing::Types<boost::adjacency_list<boost::setS, boost::vecS, boost::directedS>, Graph> testlist;
+typedef testing::Types<boost::adjacency_list<boost::setS, boost::vecS, boost::directedS>, Graph, basic_graph<std::size_t, ordered_setS, std::allocator<std::size_t> >, basic_graph<std::uint32_t, sorted_vecS>, BidirectionalGraph, CSRGraph> testlist;
+typedef testing::Types<boost::adjacency_list<boost::setS, boost::vecS, boost::bidirectionalS>, BidirectionalGraph, basic_graph<std::uint32_t, sorted_vecS, std::allocator<std::uint32_t>, bidirectional_edgesS> > bidirectional_testlist;
 
 template <typename T>
 class TestGraphSample :  public testing::Test
@@ -484,6 +501,12 @@ TYPED_TEST_CASE(TestGraphSample, testlist);
 TYPED_TEST_CASE(TestGraphBasic, testlist);
 TYPED_TEST_CASE(TestGraphGeneral, testlist);
 
+template <typename T>
+class TestGraphBidirectional : public TestGraphSample<T>
+{};
+
+TYPED_TEST_CASE(TestGraphBidirectional, bidirectional_testlist);
+
 // --------------
 // test_vertex
 // --------------
@@ -1563,6 +1586,15 @@ TYPED_TEST(TestGraphSample, test_edges)
 	}
 }
 
+TYPED_TEST(TestGraphSample, test_edges_scan)
+{
+	std::pair<typename TestFixture::edge_iterator, typename TestFixture::edge_iterator> p = edges(this->g);
+	std::ostringstream out;
+	for(typename TestFixture::edge_iterator b = p.first; b != p.second; ++b)
+		out << source(*b, this->g) << target(*b, this->g) << " ";
+	ASSERT_EQ(out.str(), "01 02 04 13 14 23 34 35 53 57 67 ");
+}
+
 // --------------
 // test_num_edges
 // --------------
@@ -1663,3 +1695,2130 @@ TYPED_TEST(TestGraphSample, test_topological_sort)
 		ASSERT_EQ(std::strcmp(se->what(), "The graph must be a DAG."), 0);
 	}
 }
+
+// ------------------
+// test_edge_iterator
+// ------------------
+
+TEST(TestGraphOnly, test_edge_iterator_reverse)
+{
+	Graph g;
+	add_edge(1, 2, g);
+	add_edge(1, 4, g);
+	add_edge(4, 0, g);
+	add_vertex(g);
+	std::pair<Graph::edge_iterator, Graph::edge_iterator> p = edges(g);
+	std::ostringstream out;
+	Graph::edge_iterator e = p.second;
+	while(e != p.first)
+	{
+		--e;
+		out << source(*e, g) << target(*e, g) << " ";
+	}
+	ASSERT_EQ(out.str(), "40 14 12 ");
+}
+
+TEST(TestGraphOnly, test_edge_iterator_jump)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(0, 3, g);
+	add_edge(2, 0, g);
+	add_edge(2, 1, g);
+	add_edge(2, 3, g);
+	add_edge(5, 4, g);
+	Graph::edge_iterator b = edges(g).first;
+	Graph::edge_iterator e = edges(g).second;
+	ASSERT_EQ(*(b + 2), std::make_pair(2ul, 0ul));
+	ASSERT_EQ(*(b + 5), std::make_pair(5ul, 4ul));
+	ASSERT_EQ(*(e - 3), std::make_pair(2ul, 1ul));
+	ASSERT_EQ(b + 6, e);
+	b += 4;
+	ASSERT_EQ(*b, std::make_pair(2ul, 3ul));
+	b -= 3;
+	ASSERT_EQ(*b, std::make_pair(0ul, 3ul));
+	++b;
+	ASSERT_EQ(*b, std::make_pair(2ul, 0ul));
+}
+
+TEST(TestGraphOnly, test_edge_iterator_jump_every)
+{
+	Graph g;
+	add_edge(1, 2, g);
+	add_edge(1, 4, g);
+	add_edge(4, 0, g);
+	add_edge(4, 3, g);
+	add_edge(7, 1, g);
+	add_vertex(g);
+	const std::vector<Graph::edge_descriptor> ed(edges(g).first, edges(g).second);
+	for(std::size_t i = 0; i <= ed.size(); ++i)
+	{
+		for(std::size_t j = 0; j <= ed.size(); ++j)
+		{
+			Graph::edge_iterator p = edges(g).first + i;
+			if(j >= i)
+				p += j - i;
+			else
+				p -= i - j;
+			ASSERT_EQ(p, edges(g).first + j);
+			if(j != ed.size())
+			{
+				ASSERT_EQ(*p, ed[j]);
+				++p;
+				--p;
+				ASSERT_EQ(*p, ed[j]);
+			}
+		}
+	}
+}
+
+TEST(TestGraphOnly, test_edge_iterator_jump_threads)
+{
+	Graph g;
+	for(std::size_t u = 0; u != 200; ++u)
+	{
+		for(std::size_t v = u % 3; v < 200; v += 7)
+			add_edge(u, v, g);
+	}
+	const Graph& c = g;
+	const std::vector<Graph::edge_descriptor> ed(edges(c).first, edges(c).second);
+	std::vector<int> mismatches(4, 0);
+	std::vector<std::thread> threads;
+	for(std::size_t t = 0; t != mismatches.size(); ++t)
+	{
+		threads.push_back(std::thread([&, t] ()
+		{
+			for(std::size_t i = t; i < ed.size(); i += 3)
+				mismatches[t] += !(*(edges(c).first + i) == ed[i]) + !(*(edges(c).second - (ed.size() - i)) == ed[i]);
+		}));
+	}
+	for(std::thread& thread : threads)
+		thread.join();
+	ASSERT_EQ(mismatches, std::vector<int>(4, 0));
+}
+
+TEST(TestGraphOnly, test_edge_iterator_add_edge)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	ASSERT_EQ(*(edges(g).second - 1), std::make_pair(0ul, 1ul));
+	add_edge(3, 2, g);
+	ASSERT_EQ(*(edges(g).second - 1), std::make_pair(3ul, 2ul));
+	ASSERT_EQ(std::distance(edges(g).first, edges(g).second), 2);
+}
+
+// -------------
+// test_csrgraph
+// -------------
+
+TEST(TestGraphOnly, test_csrgraph_range_constructor)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{3, 1}, {0, 2}, {0, 1}, {3, 1}, {1, 5}};
+	CSRGraph g(ed.begin(), ed.end());
+	ASSERT_EQ(num_vertices(g), 6);
+	ASSERT_EQ(num_edges(g), 4);
+	std::ostringstream out;
+	for(CSRGraph::edge_iterator b = edges(g).first; b != edges(g).second; ++b)
+		out << source(*b, g) << target(*b, g) << " ";
+	ASSERT_EQ(out.str(), "01 02 15 31 ");
+	ASSERT_TRUE(edge(3, 1, g).second);
+	ASSERT_FALSE(edge(1, 3, g).second);
+	ASSERT_EQ(*(edges(g).first + 3), std::make_pair(3ul, 1ul));
+	ASSERT_EQ(*(edges(g).second - 2), std::make_pair(1ul, 5ul));
+}
+
+TEST(TestGraphOnly, test_csrgraph_conversion_constructor)
+{
+	Graph g;
+	add_edge(2, 0, g);
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	add_vertex(g);
+	CSRGraph c(g);
+	ASSERT_EQ(num_vertices(c), 4);
+	ASSERT_EQ(num_edges(c), 3);
+	ASSERT_TRUE(has_cycle(c));
+	std::pair<CSRGraph::adjacency_iterator, CSRGraph::adjacency_iterator> av = adjacent_vertices(2, c);
+	ASSERT_EQ(std::distance(av.first, av.second), 1);
+	ASSERT_EQ(*av.first, 0);
+}
+
+// --------------
+// test_has_cycle
+// --------------
+
+TEST(TestGraphOnly, test_has_cycle_path)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	add_edge(2, 3, g);
+	add_edge(3, 1, g);
+	add_edge(0, 4, g);
+	std::ostringstream out;
+	ASSERT_TRUE(has_cycle(g, std::ostream_iterator<Graph::vertex_descriptor>(out, " ")));
+	ASSERT_EQ(out.str(), "1 2 3 ");
+}
+
+TEST(TestGraphOnly, test_has_cycle_path_self_loop)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 1, g);
+	std::vector<Graph::vertex_descriptor> cycle;
+	ASSERT_TRUE(has_cycle(g, std::back_inserter(cycle)));
+	ASSERT_EQ(cycle, std::vector<Graph::vertex_descriptor>(1, 1));
+}
+
+TEST(TestGraphOnly, test_has_cycle_path_none)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(0, 2, g);
+	add_edge(1, 2, g);
+	std::vector<Graph::vertex_descriptor> cycle;
+	ASSERT_FALSE(has_cycle(g, std::back_inserter(cycle)));
+	ASSERT_TRUE(cycle.empty());
+}
+
+// ---------------------
+// test_topological_sort
+// ---------------------
+
+TEST(TestGraphOnly, test_topological_sort_deep_chain)
+{
+	const std::size_t n = 200000;
+	Graph g;
+	for(std::size_t v = 0; v + 1 < n; ++v)
+		add_edge(v, v + 1, g);
+	std::vector<Graph::vertex_descriptor> order;
+	topological_sort(g, std::back_inserter(order));
+	ASSERT_EQ(order.size(), n);
+	ASSERT_EQ(order.front(), n - 1);
+	ASSERT_EQ(order.back(), 0);
+	ASSERT_FALSE(has_cycle(g));
+
+	add_edge(n - 1, 0, g);
+	ASSERT_TRUE(has_cycle(g));
+	ASSERT_THROW(topological_sort(g, std::back_inserter(order)), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_topological_sort_ascending_neighbors)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{0, 3}, {0, 1}, {0, 2}, {2, 1}, {4, 0}};
+	CSRGraph g(ed.begin(), ed.end());
+	std::ostringstream out;
+	topological_sort(g, std::ostream_iterator<CSRGraph::vertex_descriptor>(out, " "));
+	ASSERT_EQ(out.str(), "1 2 3 0 4 ");
+}
+
+// ----------------------
+// test_topological_levels
+// ----------------------
+
+TYPED_TEST(TestGraphBasic, test_topological_levels) 
+{
+	ThreadPool pool(3);
+	std::vector<std::vector<typename TestFixture::vertex_descriptor> > levels = topological_levels(this->g, pool);
+	ASSERT_EQ(levels.size(), 2);
+	ASSERT_EQ(levels[0], std::vector<typename TestFixture::vertex_descriptor>({0, 3, 4, 5, 6}));
+	ASSERT_EQ(levels[1], std::vector<typename TestFixture::vertex_descriptor>({1, 2}));
+}
+
+TYPED_TEST(TestGraphBasic, test_parallel_topological_sort) 
+{
+	std::ostringstream out;
+	parallel_topological_sort(this->g, std::ostream_iterator<typename TestFixture::vertex_descriptor>(out, " "));
+	ASSERT_EQ(out.str(), "1 2 0 3 4 5 6 ");
+}
+
+TYPED_TEST(TestGraphSample, test_parallel_topological_sort) 
+{
+	std::ostringstream out;
+	ASSERT_THROW(parallel_topological_sort(this->g, std::ostream_iterator<typename TestFixture::vertex_descriptor>(out, " ")), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_topological_levels_large)
+{
+	// Every vertex v has edges to 2v + 1 and 2v + 2, so level d holds the vertices [2^d - 1, 2^(d + 1) - 1)
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	const std::size_t n = (1 << 16) - 1;
+	for(std::size_t v = 0; 2 * v + 2 < n; ++v)
+	{
+		ed.push_back(std::make_pair(v, 2 * v + 1));
+		ed.push_back(std::make_pair(v, 2 * v + 2));
+	}
+	CSRGraph g(ed.begin(), ed.end());
+	ThreadPool pool(4);
+	std::vector<std::vector<CSRGraph::vertex_descriptor> > levels = topological_levels(g, pool);
+	ASSERT_EQ(levels.size(), 16);
+	for(std::size_t d = 0; d < levels.size(); ++d)
+	{
+		ASSERT_EQ(levels[d].size(), 1u << d);
+		ASSERT_EQ(levels[d].front(), (1u << d) - 1);
+		ASSERT_TRUE(std::is_sorted(levels[d].begin(), levels[d].end()));
+	}
+}
+
+// ------------------
+// test_parallel_sort
+// ------------------
+
+TEST(TestGraphOnly, test_parallel_sort)
+{
+	std::vector<int> a(100000);
+	for(std::size_t i = 0; i < a.size(); ++i)
+		a[i] = static_cast<int>((i * 7919) % 100003);
+	std::vector<int> b = a;
+	ThreadPool pool(5);
+	parallel_sort(pool, a.begin(), a.end());
+	std::sort(b.begin(), b.end());
+	ASSERT_EQ(a, b);
+}
+
+// ---------------------
+// test_build_from_edges
+// ---------------------
+
+TEST(TestGraphOnly, test_graph_range_constructor)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{3, 1}, {0, 2}, {0, 1}, {3, 1}, {1, 5}};
+	Graph g(ed.begin(), ed.end(), 8);
+	ASSERT_EQ(num_vertices(g), 8);
+	ASSERT_EQ(num_edges(g), 4);
+	std::ostringstream out;
+	for(Graph::edge_iterator b = edges(g).first; b != edges(g).second; ++b)
+		out << source(*b, g) << target(*b, g) << " ";
+	ASSERT_EQ(out.str(), "01 02 15 31 ");
+	ASSERT_EQ(*(vertices(g).second - 1), 7);
+}
+
+TEST(TestGraphOnly, test_build_from_edges_existing)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(2, 0, g);
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{2, 0}, {0, 1}, {0, 3}, {2, 1}};
+	build_from_edges(ed.begin(), ed.end(), 0, g);
+	ASSERT_EQ(num_vertices(g), 4);
+	ASSERT_EQ(num_edges(g), 4);
+	ASSERT_TRUE(edge(0, 3, g).second);
+	ASSERT_TRUE(edge(2, 1, g).second);
+	ASSERT_FALSE(add_edge(2, 1, g).second);
+}
+
+TEST(TestGraphOnly, test_build_from_edges_parallel)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i < 50000; ++i)
+		ed.push_back(std::make_pair((i * 31) % 1000, (i * 17) % 997));
+	ThreadPool pool(4);
+	Graph g(ed.begin(), ed.end(), 0, pool);
+	CSRGraph c(ed.begin(), ed.end(), 0, pool);
+	Graph h;
+	for(std::size_t i = 0; i < ed.size(); ++i)
+		add_edge(ed[i].first, ed[i].second, h);
+	ASSERT_EQ(num_edges(g), num_edges(h));
+	ASSERT_EQ(num_edges(c), num_edges(h));
+	ASSERT_EQ(num_vertices(g), num_vertices(h));
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(h).first));
+	ASSERT_TRUE(std::equal(edges(c).first, edges(c).second, edges(h).first));
+}
+
+// ------------------
+// test_graph_snapshot
+// ------------------
+
+TEST(TestGraphOnly, test_snapshot_round_trip)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{0, 4}, {0, 1}, {2, 1}, {4, 2}, {3, 0}};
+	Graph g(ed.begin(), ed.end(), 6);
+	save_snapshot(g, "TestGraph.snapshot");
+	MappedGraph m("TestGraph.snapshot");
+	ASSERT_TRUE(verify(m));
+	ASSERT_EQ(num_vertices(m), 6);
+	ASSERT_EQ(num_edges(m), 5);
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(m).first));
+	ASSERT_TRUE(edge(4, 2, m).second);
+	ASSERT_FALSE(edge(2, 4, m).second);
+	ASSERT_FALSE(has_cycle(m));
+
+	std::ostringstream expected;
+	std::ostringstream out;
+	topological_sort(g, std::ostream_iterator<Graph::vertex_descriptor>(expected, " "));
+	topological_sort(m, std::ostream_iterator<MappedGraph::vertex_descriptor>(out, " "));
+	ASSERT_EQ(out.str(), expected.str());
+
+	CSRGraph c(m);
+	ASSERT_EQ(num_edges(c), 5);
+	std::remove("TestGraph.snapshot");
+}
+
+TEST(TestGraphOnly, test_snapshot_corrupt)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	save_snapshot(g, "TestGraph.snapshot");
+	{
+		// Flip the last target: the header is still valid, but the payload is not
+		std::fstream f("TestGraph.snapshot", std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(-1, std::ios::end);
+		f.put(7);
+	}
+	MappedGraph m("TestGraph.snapshot");
+	ASSERT_FALSE(verify(m));
+	{
+		std::fstream f("TestGraph.snapshot", std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(20);
+		f.put(9);
+	}
+	ASSERT_THROW(MappedGraph("TestGraph.snapshot"), std::runtime_error);
+	ASSERT_THROW(MappedGraph("TestGraph.missing"), std::runtime_error);
+	std::remove("TestGraph.snapshot");
+}
+
+TEST(TestGraphOnly, test_snapshot_replace_while_mapped)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{0, 1}, {1, 2}, {2, 3}};
+	Graph g(ed.begin(), ed.end());
+	save_snapshot(g, "TestGraph.snapshot");
+	MappedGraph old("TestGraph.snapshot");
+
+	Graph h;
+	add_edge(5, 4, h);
+	save_snapshot(h, "TestGraph.snapshot");
+	MappedGraph reloaded("TestGraph.snapshot");
+
+	// The old mapping still reads the file it mapped, whole
+	ASSERT_TRUE(verify(old));
+	ASSERT_EQ(num_vertices(old), 4);
+	ASSERT_EQ(num_edges(old), 3);
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(old).first));
+	ASSERT_TRUE(verify(reloaded));
+	ASSERT_EQ(num_vertices(reloaded), 6);
+	ASSERT_EQ(num_edges(reloaded), 1);
+	ASSERT_TRUE(edge(5, 4, reloaded).second);
+	std::remove("TestGraph.snapshot");
+}
+
+TEST(TestGraphOnly, test_snapshot_crafted)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	save_snapshot(g, "TestGraph.snapshot");
+	snapshot_header header;
+	std::uint64_t payload[6];
+	{
+		std::ifstream f("TestGraph.snapshot", std::ios::binary);
+		f.read(reinterpret_cast<char*>(&header), sizeof(header));
+		f.read(reinterpret_cast<char*>(payload), sizeof(payload));
+	}
+	const snapshot_header saved = header;
+
+	// (2^61 + 3 + 3) * 8 wraps to the real payload size, 48 bytes
+	header.num_vertices = (std::uint64_t(1) << 61) + 3;
+	header.header_checksum = snapshot_checksum(header);
+	{
+		std::fstream f("TestGraph.snapshot", std::ios::in | std::ios::out | std::ios::binary);
+		f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+	ASSERT_THROW(MappedGraph("TestGraph.snapshot"), std::runtime_error);
+
+	// A target past the last vertex, with both checksums rewritten to match
+	header = saved;
+	payload[5] = 9;
+	header.payload_checksum = snapshot_checksum(payload, payload + 6);
+	header.header_checksum = snapshot_checksum(header);
+	{
+		std::fstream f("TestGraph.snapshot", std::ios::in | std::ios::out | std::ios::binary);
+		f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		f.write(reinterpret_cast<const char*>(payload), sizeof(payload));
+	}
+	MappedGraph m("TestGraph.snapshot");
+	ASSERT_FALSE(verify(m));
+	std::remove("TestGraph.snapshot");
+}
+
+// -------------------
+// test_read_edge_list
+// -------------------
+
+TEST(TestGraphOnly, test_read_edge_list_pairs)
+{
+	std::istringstream in("# comment\n0 1\n\n  2\t3  \n% other comment\r\n4 0 7.5\n5 6");
+	std::vector<std::pair<std::uint64_t, std::uint64_t> > ed;
+	std::size_t batches = 0;
+	std::uint64_t n = read_edge_list(in, edge_list_pairs, [&] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >& batch)
+	{
+		ed.insert(ed.end(), batch.begin(), batch.end());
+		++batches;
+	}, 2);
+	ASSERT_EQ(n, 0);
+	ASSERT_EQ(batches, 2);
+	std::vector<std::pair<std::uint64_t, std::uint64_t> > expected = {{0, 1}, {2, 3}, {4, 0}, {5, 6}};
+	ASSERT_EQ(ed, expected);
+}
+
+TEST(TestGraphOnly, test_read_edge_list_malformed)
+{
+	std::istringstream in("0 1\n2 x\n");
+	ASSERT_THROW(read_edge_list(in, edge_list_snap, [] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) {}), std::runtime_error);
+}
+
+TEST(TestGraphOnly, test_read_edge_list_overflow)
+{
+	std::vector<std::pair<std::uint64_t, std::uint64_t> > ed;
+	std::istringstream largest("18446744073709551615 0\n");
+	read_edge_list(largest, edge_list_pairs, [&] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >& batch)
+	{
+		ed.insert(ed.end(), batch.begin(), batch.end());
+	});
+	ASSERT_EQ(ed.size(), 1);
+	ASSERT_EQ(ed[0].first, std::numeric_limits<std::uint64_t>::max());
+
+	std::istringstream wraps("0 1\n18446744073709551616 0\n");
+	ASSERT_THROW(read_edge_list(wraps, edge_list_pairs, [] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) {}), std::runtime_error);
+	std::istringstream problem("p sp 99999999999999999999 1\n");
+	ASSERT_THROW(read_edge_list(problem, edge_list_dimacs, [] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >&) {}), std::runtime_error);
+}
+
+TEST(TestGraphOnly, test_load_edge_list_dimacs)
+{
+	{
+		std::ofstream out("TestGraph.dimacs");
+		out << "c a small graph\np sp 6 3\na 1 2 10\na 2 3 4\na 3 1 1\n";
+	}
+	Graph g;
+	load_edge_list("TestGraph.dimacs", edge_list_dimacs, g);
+	ASSERT_EQ(num_vertices(g), 6);
+	ASSERT_EQ(num_edges(g), 3);
+	ASSERT_TRUE(edge(0, 1, g).second);
+	ASSERT_TRUE(edge(2, 0, g).second);
+	ASSERT_TRUE(has_cycle(g));
+	std::remove("TestGraph.dimacs");
+}
+
+TEST(TestGraphOnly, test_load_edge_list_narrow)
+{
+	typedef basic_graph<std::uint32_t, sorted_vecS> CompactGraph;
+	{
+		std::ofstream out("TestGraph.snap");
+		out << "0\t5\n";
+	}
+	CompactGraph g;
+	load_edge_list("TestGraph.snap", edge_list_snap, g);
+	ASSERT_TRUE(edge(0, 5, g).second);
+	{
+		std::ofstream out("TestGraph.snap");
+		out << "0\t1\n4294967296\t2\n";
+	}
+	CompactGraph h;
+	ASSERT_THROW(load_edge_list("TestGraph.snap", edge_list_snap, h), std::runtime_error);
+	ThreadPool pool(2);
+	ASSERT_THROW(load_edge_list("TestGraph.snap", edge_list_snap, h, pool), std::runtime_error);
+	{
+		std::ofstream out("TestGraph.snap");
+		out << "p sp 4294967297 1\na 1 2\n";
+	}
+	ASSERT_THROW(load_edge_list("TestGraph.snap", edge_list_dimacs, h), std::runtime_error);
+	std::remove("TestGraph.snap");
+}
+
+TEST(TestGraphOnly, test_load_edge_list_parallel)
+{
+	const std::size_t n = 700000;
+	{
+		std::ofstream out("TestGraph.snap");
+		out << "# FromNodeId\tToNodeId\n";
+		for(std::size_t i = 0; i < n; ++i)
+			out << 100000 + i << "\t" << 100000 + (i * 7) % n << "\n";
+	}
+	ThreadPool pool(4);
+	Graph g;
+	Graph h;
+	load_edge_list("TestGraph.snap", edge_list_snap, g, pool);
+	std::ifstream in("TestGraph.snap");
+	read_edge_list(in, edge_list_snap, [&] (const std::vector<std::pair<std::uint64_t, std::uint64_t> >& batch)
+	{
+		build_from_edges(batch.begin(), batch.end(), 0, h);
+	});
+	ASSERT_EQ(num_edges(g), n);
+	ASSERT_EQ(num_vertices(g), 100000 + n);
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(h).first));
+	std::remove("TestGraph.snap");
+}
+
+// --------------------
+// test_adjacency_index
+// --------------------
+
+TEST(TestGraphOnly, test_adjacency_index_hash)
+{
+	std::vector<std::size_t> adjacent;
+	for(std::size_t v = 0; v < 100; ++v)
+		adjacent.push_back(7 * v);
+	adjacency_index<std::size_t> index(adjacent.begin(), adjacent.end(), adjacent.size(), 1000000);
+	ASSERT_EQ(index.size(), 100);
+	for(std::size_t v = 0; v < 700; ++v)
+		ASSERT_EQ(index.contains(v), v % 7 == 0);
+	for(std::size_t v = 100; v < 1000; ++v)
+		index.insert(7 * v, 1000000);
+	ASSERT_TRUE(index.contains(6993));
+	ASSERT_FALSE(index.contains(6994));
+}
+
+TEST(TestGraphOnly, test_adjacency_index_dense)
+{
+	std::vector<std::size_t> adjacent = {1, 3, 64, 65};
+	adjacency_index<std::size_t> index(adjacent.begin(), adjacent.end(), adjacent.size(), 200);
+	ASSERT_TRUE(index.contains(64));
+	ASSERT_FALSE(index.contains(2));
+	ASSERT_FALSE(index.contains(100000));
+	index.insert(100000, 200);
+	ASSERT_TRUE(index.contains(100000));
+	ASSERT_EQ(index.size(), 5);
+}
+
+TEST(TestGraphOnly, test_edge_hub)
+{
+	// Vertex 0 becomes a hub, and vertex 1 a dense row
+	Graph g;
+	add_vertex(g);
+	for(std::size_t v = 0; v < 5000; ++v)
+		add_edge(0, 3 * v + 1, g);
+	for(std::size_t v = 0; v < 2000; ++v)
+		add_edge(1, v, g);
+	ASSERT_EQ(g.hubs.size(), 2);
+	ASSERT_TRUE(edge(0, 14998, g).second);
+	ASSERT_FALSE(edge(0, 14999, g).second);
+	ASSERT_FALSE(add_edge(0, 301, g).second);
+	ASSERT_TRUE(edge(1, 1999, g).second);
+	ASSERT_FALSE(edge(1, 2000, g).second);
+	ASSERT_EQ(num_edges(g), 7000);
+
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t v = 0; v < 100; ++v)
+		ed.push_back(std::make_pair(2, 2 * v));
+	build_from_edges(ed.begin(), ed.end(), 0, g);
+	ASSERT_TRUE(edge(2, 198, g).second);
+	ASSERT_FALSE(edge(2, 197, g).second);
+	ASSERT_EQ(g.hubs.size(), 3);
+}
+
+// ----------
+// test_arena
+// ----------
+
+TEST(TestGraphOnly, test_arena_reuse)
+{
+	Arena a;
+	ASSERT_EQ(a.capacity(), 0);
+	void* p = a.allocate(40);
+	void* q = a.allocate(48);
+	ASSERT_EQ(static_cast<char*>(q) - static_cast<char*>(p), 48);
+	ASSERT_EQ(a.capacity(), arena_first_chunk);
+	a.deallocate(p, 40);
+	ASSERT_EQ(a.allocate(33), p);
+	void* large = a.allocate(arena_max_small + 1);
+	a.deallocate(large, arena_max_small + 1);
+	ASSERT_EQ(a.capacity(), arena_first_chunk);
+}
+
+TEST(TestGraphOnly, test_arena_chunks)
+{
+	Arena a;
+	for(std::size_t i = 0; i < 1000; ++i)
+		a.allocate(arena_max_small);
+	ASSERT_GE(a.capacity(), 1000 * arena_max_small);
+	ASSERT_LE(a.capacity(), 4 * 1000 * arena_max_small);
+}
+
+TEST(TestGraphOnly, test_arena_allocator_rebind)
+{
+	arena_allocator<std::size_t> a;
+	arena_allocator<double> b(a);
+	arena_allocator<std::size_t> c;
+	ASSERT_TRUE(a == b);
+	ASSERT_TRUE(a != c);
+	ASSERT_TRUE(a.select_on_container_copy_construction() != a);
+	c = a;
+	ASSERT_TRUE(a == c);
+	ASSERT_EQ(a.heap.use_count(), 3);
+}
+
+TEST(TestGraphOnly, test_graph_shared_arena)
+{
+	arena_allocator<std::size_t> a;
+	Graph g(a);
+	Graph h(a);
+	add_edge(0, 1, g);
+	add_edge(1, 0, h);
+	ASSERT_EQ(&g.allocator.arena(), &h.allocator.arena());
+	ASSERT_EQ(a.arena().capacity(), arena_first_chunk);
+	ASSERT_TRUE(edge(0, 1, g).second);
+	ASSERT_FALSE(edge(0, 1, h).second);
+}
+
+TEST(TestGraphOnly, test_graph_copy)
+{
+	Graph g;
+	for(std::size_t v = 0; v < 100; ++v)
+		add_edge(v, (v + 1) % 100, g);
+	Graph h = g;
+	ASSERT_NE(&g.allocator.arena(), &h.allocator.arena());
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(h).first));
+	add_edge(0, 2, h);
+	ASSERT_EQ(num_edges(g), 100);
+	ASSERT_EQ(num_edges(h), 101);
+	g = h;
+	ASSERT_TRUE(edge(0, 2, g).second);
+	ASSERT_NE(&g.allocator.arena(), &h.allocator.arena());
+}
+
+TEST(TestGraphOnly, test_graph_move)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	const Arena* arena = &g.allocator.arena();
+	Graph h = std::move(g);
+	ASSERT_EQ(&h.allocator.arena(), arena);
+	ASSERT_EQ(num_edges(h), 1);
+	ASSERT_EQ(num_edges(g), 0);
+	ASSERT_EQ(num_vertices(g), 0);
+	add_edge(2, 3, g);
+	ASSERT_EQ(num_vertices(g), 4);
+}
+
+// ------------------
+// test_sorted_vector
+// ------------------
+
+TEST(TestGraphOnly, test_sorted_vector_insert)
+{
+	sorted_vector<int> s;
+	ASSERT_TRUE(s.insert(5).second);
+	ASSERT_TRUE(s.insert(1).second);
+	ASSERT_FALSE(s.insert(5).second);
+	ASSERT_EQ(*s.insert(s.end(), 9), 9);
+	ASSERT_EQ(*s.insert(s.end(), 3), 3);
+	ASSERT_EQ(*s.insert(s.begin(), 9), 9);
+	ASSERT_EQ(s.size(), 4);
+	ASSERT_EQ(std::vector<int>(s.begin(), s.end()), std::vector<int>({1, 3, 5, 9}));
+}
+
+TEST(TestGraphOnly, test_sorted_vector_find_erase)
+{
+	std::vector<int> v = {4, 2, 8, 2, 6};
+	sorted_vector<int> s(v.begin(), v.end());
+	ASSERT_EQ(s.size(), 4);
+	ASSERT_EQ(*s.find(6), 6);
+	ASSERT_TRUE(s.find(5) == s.end());
+	ASSERT_TRUE(s.find(9) == s.end());
+	ASSERT_EQ(s.erase(2), 1);
+	ASSERT_EQ(s.erase(2), 0);
+	ASSERT_EQ(*s.begin(), 4);
+	sorted_vector<int> t(s, std::allocator<int>());
+	ASSERT_TRUE(s == t);
+	t.clear();
+	ASSERT_TRUE(t.empty());
+	ASSERT_TRUE(s != t);
+}
+
+TEST(TestGraphOnly, test_graph_compact)
+{
+	typedef basic_graph<std::uint32_t, sorted_vecS> CompactGraph;
+	ASSERT_EQ(sizeof(CompactGraph::vertex_descriptor), 4);
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{3, 1}, {0, 2}, {3, 0}, {0, 1}, {3, 0}};
+	CompactGraph g(ed.begin(), ed.end());
+	ASSERT_EQ(num_edges(g), 4);
+	ASSERT_EQ(num_vertices(g), 4);
+	add_edge(3, 2, g);
+	add_edge(0, 0, g);
+	std::vector<CompactGraph::vertex_descriptor> adjacent(adjacent_vertices(3, g).first, adjacent_vertices(3, g).second);
+	ASSERT_EQ(adjacent, std::vector<CompactGraph::vertex_descriptor>({0, 1, 2}));
+	ASSERT_TRUE(has_cycle(g));
+	ASSERT_EQ(CSRGraph(g).targets, std::vector<CSRGraph::vertex_descriptor>({0, 1, 2, 0, 1, 2}));
+}
+
+TEST(TestGraphOnly, test_graph_compact_hub)
+{
+	basic_graph<std::uint32_t, sorted_vecS> g;
+	for(std::uint32_t v = 0; v < 5000; ++v)
+		add_edge(0, 5000 - v, g);
+	ASSERT_EQ(g.hubs.size(), 1);
+	ASSERT_TRUE(edge(0, 1, g).second);
+	ASSERT_FALSE(edge(0, 0, g).second);
+	ASSERT_TRUE(std::is_sorted(adjacent_vertices(0, g).first, adjacent_vertices(0, g).second));
+	std::vector<std::uint32_t> order;
+	topological_sort(g, std::back_inserter(order));
+	ASSERT_EQ(order.back(), 0);
+}
+
+// --------------------
+// test_vertex_iterator
+// --------------------
+
+TEST(TestGraphOnly, test_vertex_iterator_random_access)
+{
+	Graph g;
+	add_edge(0, 9, g);
+	std::pair<Graph::vertex_iterator, Graph::vertex_iterator> p = vertices(g);
+	ASSERT_TRUE((std::is_same<std::iterator_traits<Graph::vertex_iterator>::iterator_category, std::random_access_iterator_tag>::value));
+	ASSERT_EQ(p.second - p.first, 10);
+	ASSERT_EQ(*(p.first + 7), 7);
+	ASSERT_EQ(p.first[3], 3);
+	ASSERT_EQ(*(p.second - 1), 9);
+	add_vertex(g);
+	ASSERT_EQ(std::distance(vertices(g).first, vertices(g).second), 11);
+}
+
+TEST(TestGraphOnly, test_vertex_iterator_compact)
+{
+	basic_graph<std::uint32_t, sorted_vecS> g;
+	ASSERT_TRUE(vertices(g).first == vertices(g).second);
+	for(std::size_t i = 0; i < 1000; ++i)
+		add_vertex(g);
+	ASSERT_EQ(g.g.capacity() < 2048, true);
+	std::uint32_t sum = std::accumulate(vertices(g).first, vertices(g).second, 0u);
+	ASSERT_EQ(sum, 999u * 1000u / 2);
+}
+
+// ----------------
+// test_remove_edge
+// ----------------
+
+TEST(TestGraphOnly, test_adjacency_index_erase)
+{
+	std::vector<std::size_t> adjacent;
+	for(std::size_t v = 0; v < 200; ++v)
+		adjacent.push_back(v * 1024);
+	adjacency_index<std::size_t> index(adjacent.begin(), adjacent.end(), adjacent.size(), 1000000);
+	for(std::size_t v = 0; v < 200; v += 2)
+		index.erase(v * 1024);
+	ASSERT_EQ(index.size(), 100);
+	for(std::size_t v = 0; v < 200; ++v)
+		ASSERT_EQ(index.contains(v * 1024), v % 2 == 1);
+
+	adjacency_index<std::size_t> dense(adjacent.begin(), adjacent.begin() + 40, 40, 100);
+	dense.erase(1024);
+	ASSERT_FALSE(dense.contains(1024));
+	ASSERT_TRUE(dense.contains(2048));
+	ASSERT_EQ(dense.size(), 39);
+}
+
+TEST(TestGraphOnly, test_remove_edge)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(0, 2, g);
+	add_edge(2, 1, g);
+	remove_edge(0, 2, g);
+	remove_edge(std::make_pair(2, 1), g);
+	remove_edge(2, 0, g);
+	remove_edge(7, 0, g);
+	ASSERT_EQ(num_edges(g), 1);
+	ASSERT_EQ(num_vertices(g), 3);
+	ASSERT_FALSE(edge(0, 2, g).second);
+	ASSERT_EQ(std::distance(edges(g).first, edges(g).second), 1);
+	ASSERT_EQ(*edges(g).first, std::make_pair(0ul, 1ul));
+}
+
+TEST(TestGraphOnly, test_remove_edge_hub)
+{
+	basic_graph<std::uint32_t, sorted_vecS> g;
+	for(std::uint32_t v = 0; v < 100; ++v)
+		add_edge(0, v, g);
+	ASSERT_EQ(g.hubs.size(), 1);
+	for(std::uint32_t v = 0; v < 100; v += 2)
+		remove_edge(0, v, g);
+	ASSERT_EQ(g.hubs.size(), 1);
+	ASSERT_FALSE(edge(0, 50, g).second);
+	ASSERT_TRUE(edge(0, 51, g).second);
+	for(std::uint32_t v = 1; v < 60; v += 2)
+		remove_edge(0, v, g);
+	ASSERT_EQ(g.hubs.size(), 0);
+	ASSERT_EQ(num_edges(g), 20);
+	ASSERT_TRUE(edge(0, 61, g).second);
+	ASSERT_FALSE(edge(0, 59, g).second);
+}
+
+TEST(TestGraphOnly, test_clear_vertex)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 1, g);
+	add_edge(1, 2, g);
+	add_edge(2, 1, g);
+	add_edge(2, 0, g);
+	clear_vertex(1, g);
+	ASSERT_EQ(num_edges(g), 1);
+	ASSERT_EQ(num_vertices(g), 3);
+	ASSERT_TRUE(edge(2, 0, g).second);
+	ASSERT_FALSE(has_cycle(g));
+}
+
+// ------------------
+// test_remove_vertex
+// ------------------
+
+TEST(TestGraphOnly, test_remove_vertex)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	add_edge(2, 3, g);
+	add_edge(3, 1, g);
+	remove_vertex(1, g);
+	ASSERT_TRUE(is_removed(1, g));
+	ASSERT_FALSE(is_removed(2, g));
+	ASSERT_EQ(num_vertices(g), 4);
+	ASSERT_EQ(num_edges(g), 1);
+	ASSERT_TRUE(edge(2, 3, g).second);
+	ASSERT_FALSE(has_cycle(g));
+
+	remove_vertex(3, g);
+	ASSERT_EQ(num_vertices(g), 3);
+	ASSERT_EQ(num_edges(g), 0);
+	remove_vertex(2, g);
+	ASSERT_EQ(num_vertices(g), 1);
+	ASSERT_FALSE(is_removed(1, g));
+}
+
+TEST(TestGraphOnly, test_remove_vertex_revive)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	remove_vertex(1, g);
+	add_edge(2, 1, g);
+	ASSERT_FALSE(is_removed(1, g));
+	ASSERT_EQ(compact(g), std::vector<std::size_t>({0, 1, 2}));
+}
+
+TEST(TestGraphOnly, test_compact_arena)
+{
+	Graph g;
+	for(std::size_t u = 0; u != 1000; ++u)
+	{
+		for(std::size_t v = 0; v != 20; ++v)
+			add_edge(u, (u + v) % 1000, g);
+	}
+	const std::size_t before = g.allocator.arena().capacity();
+	for(std::size_t u = 100; u != 1000; ++u)
+		remove_vertex(u, g);
+	ASSERT_EQ(g.allocator.arena().capacity(), before);
+	compact(g);
+	ASSERT_EQ(num_vertices(g), 100);
+	ASSERT_LT(4 * g.allocator.arena().capacity(), before);
+	ASSERT_TRUE(edge(0, 19, g).second);
+	ASSERT_FALSE(edge(99, 0, g).second);
+
+	// A graph that shared an arena leaves it, and the other graph keeps it
+	arena_allocator<std::size_t> a;
+	Graph h(a);
+	Graph k(a);
+	add_edge(0, 1, h);
+	add_edge(1, 0, k);
+	remove_vertex(1, h);
+	compact(h);
+	ASSERT_TRUE(h.allocator != a);
+	ASSERT_TRUE(k.allocator == a);
+	ASSERT_TRUE(edge(1, 0, k).second);
+}
+
+TEST(TestGraphOnly, test_compact)
+{
+	basic_graph<std::uint32_t, sorted_vecS> g;
+	for(std::uint32_t v = 0; v < 100; ++v)
+	{
+		add_edge(0, v, g);
+		add_edge(v, 99, g);
+	}
+	for(std::uint32_t v = 1; v < 99; v += 3)
+		remove_vertex(v, g);
+	const std::size_t e = num_edges(g);
+	std::vector<std::uint32_t> renumber = compact(g);
+	const std::uint32_t null = std::numeric_limits<std::uint32_t>::max();
+	ASSERT_EQ(renumber[1], null);
+	ASSERT_EQ(renumber[2], 1);
+	ASSERT_EQ(renumber[99], 66);
+	ASSERT_EQ(num_vertices(g), 67);
+	ASSERT_EQ(num_edges(g), e);
+	ASSERT_EQ(g.hubs.size(), 1);
+	ASSERT_TRUE(edge(0, 66, g).second);
+	ASSERT_TRUE(edge(1, 66, g).second);
+	ASSERT_FALSE(edge(0, 67, g).second);
+	ASSERT_EQ(static_cast<std::size_t>(std::distance(edges(g).first, edges(g).second)), e);
+	ASSERT_TRUE(std::is_sorted(adjacent_vertices(0, g).first, adjacent_vertices(0, g).second));
+}
+
+// ----------------------
+// test_topological_order
+// ----------------------
+
+///
+/// @return true if every edge of the graph goes forward in the order
+///
+template <typename G>
+bool respects (const TopologicalOrder<G>& order)
+{
+	typename G::edge_iterator b = edges(order.graph()).first;
+	typename G::edge_iterator e = edges(order.graph()).second;
+	for(; b != e; ++b)
+	{
+		if(order.position(source(*b, order.graph())) >= order.position(target(*b, order.graph())))
+			return false;
+	}
+	for(std::size_t i = 0; i != order.order().size(); ++i)
+	{
+		if(order.position(order.order()[i]) != i)
+			return false;
+	}
+	return true;
+}
+
+TEST(TestGraphOnly, test_topological_order_construct)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{2, 1}, {1, 0}, {3, 0}};
+	TopologicalOrder<Graph> order((Graph(ed.begin(), ed.end())));
+	ASSERT_EQ(order.order().size(), 4);
+	ASSERT_TRUE(respects(order));
+	ed.push_back(std::make_pair(0, 2));
+	ASSERT_THROW(TopologicalOrder<Graph>((Graph(ed.begin(), ed.end()))), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_topological_order_reorder)
+{
+	TopologicalOrder<Graph> order;
+	ASSERT_TRUE(add_edge(3, 2, order).second);
+	ASSERT_TRUE(add_edge(2, 1, order).second);
+	ASSERT_TRUE(add_edge(1, 0, order).second);
+	ASSERT_FALSE(add_edge(2, 1, order).second);
+	ASSERT_TRUE(respects(order));
+	ASSERT_EQ(order.order(), std::vector<std::size_t>({3, 2, 1, 0}));
+	ASSERT_EQ(add_vertex(order), 4);
+	ASSERT_TRUE(add_edge(0, 4, order).second);
+	ASSERT_TRUE(respects(order));
+}
+
+TEST(TestGraphOnly, test_topological_order_cycle)
+{
+	TopologicalOrder<Graph> order;
+	add_edge(0, 1, order);
+	add_edge(1, 2, order);
+	add_edge(3, 4, order);
+	std::vector<std::size_t> before = order.order();
+	ASSERT_THROW(add_edge(2, 0, order), boost::not_a_dag);
+	ASSERT_THROW(add_edge(4, 4, order), boost::not_a_dag);
+	ASSERT_EQ(num_edges(order.graph()), 3);
+	ASSERT_EQ(order.order(), before);
+	remove_edge(1, 2, order);
+	ASSERT_TRUE(add_edge(2, 0, order).second);
+	ASSERT_TRUE(respects(order));
+}
+
+TEST(TestGraphOnly, test_topological_order_random)
+{
+	// Random insertions, checked against has_cycle on a copy of the graph
+	std::mt19937 random(378);
+	TopologicalOrder<basic_graph<std::uint32_t, sorted_vecS> > order;
+	for(std::uint32_t v = 0; v < 200; ++v)
+		add_vertex(order);
+	for(std::size_t i = 0; i < 2000; ++i)
+	{
+		std::uint32_t u = random() % 200;
+		std::uint32_t v = random() % 200;
+		basic_graph<std::uint32_t, sorted_vecS> g = order.graph();
+		add_edge(u, v, g);
+		bool cyclic = has_cycle(g);
+		try
+		{
+			add_edge(u, v, order);
+			ASSERT_FALSE(cyclic);
+		}
+		catch(boost::not_a_dag&)
+		{
+			ASSERT_TRUE(cyclic);
+		}
+	}
+	ASSERT_TRUE(respects(order));
+}
+
+// -------------
+// test_in_edges
+// -------------
+
+TYPED_TEST(TestGraphBidirectional, test_in_degree)
+{
+	ASSERT_EQ(in_degree(this->vdA, this->g), 0);
+	ASSERT_EQ(in_degree(this->vdD, this->g), 3);
+	ASSERT_EQ(in_degree(this->vdE, this->g), 3);
+	ASSERT_EQ(in_degree(this->vdH, this->g), 2);
+}
+
+TYPED_TEST(TestGraphBidirectional, test_inv_adjacent_vertices)
+{
+	typedef typename TestFixture::graph_type::inv_adjacency_iterator inv_adjacency_iterator;
+	std::pair<inv_adjacency_iterator, inv_adjacency_iterator> p = inv_adjacent_vertices(this->vdD, this->g);
+	std::set<typename TestFixture::vertex_descriptor> sources(p.first, p.second);
+	ASSERT_EQ(sources, std::set<typename TestFixture::vertex_descriptor>({this->vdB, this->vdC, this->vdF}));
+}
+
+TYPED_TEST(TestGraphBidirectional, test_in_edges)
+{
+	typedef typename TestFixture::graph_type::in_edge_iterator in_edge_iterator;
+	std::pair<in_edge_iterator, in_edge_iterator> p = in_edges(this->vdE, this->g);
+	std::set<typename TestFixture::vertex_descriptor> sources;
+	for(; p.first != p.second; ++p.first)
+	{
+		ASSERT_EQ(target(*p.first, this->g), this->vdE);
+		sources.insert(source(*p.first, this->g));
+	}
+	ASSERT_EQ(sources, std::set<typename TestFixture::vertex_descriptor>({this->vdA, this->vdB, this->vdD}));
+}
+
+TYPED_TEST(TestGraphBidirectional, test_in_edges_remove)
+{
+	remove_edge(this->vdB, this->vdD, this->g);
+	ASSERT_EQ(in_degree(this->vdD, this->g), 2);
+	clear_vertex(this->vdD, this->g);
+	ASSERT_EQ(in_degree(this->vdD, this->g), 0);
+	ASSERT_EQ(in_degree(this->vdE, this->g), 2);
+	ASSERT_EQ(in_degree(this->vdF, this->g), 0);
+	ASSERT_EQ(num_edges(this->g), 6);
+}
+
+TEST(TestGraphOnly, test_in_edges_bulk)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{3, 0}, {1, 0}, {2, 0}, {0, 1}, {2, 1}, {1, 0}};
+	BidirectionalGraph g(ed.begin(), ed.end());
+	std::vector<std::size_t> sources(inv_adjacent_vertices(0, g).first, inv_adjacent_vertices(0, g).second);
+	ASSERT_EQ(sources, std::vector<std::size_t>({1, 2, 3}));
+	ASSERT_EQ(in_degree(1, g), 2);
+	BidirectionalGraph h = g;
+	add_edge(3, 1, h);
+	ASSERT_EQ(in_degree(1, g), 2);
+	ASSERT_EQ(in_degree(1, h), 3);
+}
+
+TEST(TestGraphOnly, test_in_edges_compact)
+{
+	BidirectionalGraph g;
+	add_edge(0, 3, g);
+	add_edge(1, 3, g);
+	add_edge(2, 3, g);
+	add_edge(3, 4, g);
+	remove_vertex(1, g);
+	ASSERT_EQ(in_degree(3, g), 2);
+	compact(g);
+	ASSERT_EQ(num_vertices(g), 4);
+	std::vector<std::size_t> sources(inv_adjacent_vertices(2, g).first, inv_adjacent_vertices(2, g).second);
+	ASSERT_EQ(sources, std::vector<std::size_t>({0, 1}));
+	ASSERT_EQ(*inv_adjacent_vertices(3, g).first, 2);
+	remove_vertex(3, g);
+	ASSERT_EQ(num_vertices(g), 3);
+	ASSERT_EQ(num_edges(g), 2);
+}
+
+// ----------------------------------
+// test_strongly_connected_components
+// ----------------------------------
+
+///
+/// @return true if every edge of the graph goes from a higher or equal component number to a lower or equal one
+///
+template <typename G>
+bool reverse_topological (const G& graph, const std::vector<std::size_t>& component)
+{
+	typename G::edge_iterator b = edges(graph).first;
+	typename G::edge_iterator e = edges(graph).second;
+	for(; b != e; ++b)
+	{
+		if(component[source(*b, graph)] < component[target(*b, graph)])
+			return false;
+	}
+	return true;
+}
+
+///
+/// @return true if both numberings put the same vertices together
+///
+bool same_partition (const std::vector<std::size_t>& a, const std::vector<std::size_t>& b)
+{
+	std::map<std::size_t, std::size_t> forward;
+	std::map<std::size_t, std::size_t> backward;
+	for(std::size_t i = 0; i != a.size(); ++i)
+	{
+		if(forward.insert(std::make_pair(a[i], b[i])).first->second != b[i] || backward.insert(std::make_pair(b[i], a[i])).first->second != a[i])
+			return false;
+	}
+	return a.size() == b.size();
+}
+
+TYPED_TEST(TestGraphSample, test_strongly_connected_components)
+{
+	std::vector<std::size_t> component(num_vertices(this->g));
+	ASSERT_EQ(strongly_connected_components(this->g, component.begin()), 7);
+	ASSERT_EQ(component[this->vdD], component[this->vdF]);
+	ASSERT_NE(component[this->vdD], component[this->vdE]);
+	ASSERT_NE(component[this->vdA], component[this->vdB]);
+	ASSERT_TRUE(reverse_topological(this->g, component));
+}
+
+TYPED_TEST(TestGraphSample, test_parallel_strongly_connected_components)
+{
+	std::vector<std::size_t> expected(num_vertices(this->g));
+	std::vector<std::size_t> component(num_vertices(this->g));
+	strongly_connected_components(this->g, expected.begin());
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_strongly_connected_components(this->g, component.begin(), pool), 7);
+	ASSERT_TRUE(same_partition(component, expected));
+	ASSERT_TRUE(reverse_topological(this->g, component));
+}
+
+TYPED_TEST(TestGraphSample, test_condensation)
+{
+	std::vector<std::size_t> component(num_vertices(this->g));
+	std::size_t count = strongly_connected_components(this->g, component.begin());
+	Graph dag = condensation(this->g, component.begin(), count);
+	ASSERT_EQ(num_vertices(dag), 7);
+	ASSERT_EQ(num_edges(dag), 9);
+	ASSERT_FALSE(has_cycle(dag));
+	ASSERT_TRUE(edge(component[this->vdB], component[this->vdD], dag).second);
+	ASSERT_TRUE(edge(component[this->vdF], component[this->vdE], dag).second);
+	ASSERT_TRUE(edge(component[this->vdD], component[this->vdH], dag).second);
+}
+
+TEST(TestGraphOnly, test_strongly_connected_components_deep)
+{
+	// One cycle through every vertex, deeper than a recursive search could go
+	const std::size_t n = 1 << 20;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t v = 0; v != n; ++v)
+		ed.push_back(std::make_pair(v, (v + 1) % n));
+	CSRGraph g(ed.begin(), ed.end());
+	std::vector<std::size_t> component(n);
+	ASSERT_EQ(strongly_connected_components(g, component.begin()), 1);
+	ASSERT_EQ(std::count(component.begin(), component.end(), 0), n);
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_strongly_connected_components(g, component.begin(), pool), 1);
+}
+
+TEST(TestGraphOnly, test_strongly_connected_components_dag)
+{
+	std::vector<std::pair<std::size_t, std::size_t> > ed = {{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+	Graph g(ed.begin(), ed.end());
+	std::vector<std::size_t> component(4);
+	ASSERT_EQ(strongly_connected_components(g, component.begin()), 4);
+	ASSERT_EQ(component[3], 0);
+	ASSERT_EQ(component[0], 3);
+	add_edge(2, 2, g);
+	ASSERT_EQ(strongly_connected_components(g, component.begin()), 4);
+	ASSERT_TRUE(num_edges(condensation(g, component.begin(), 4)) == 4);
+}
+
+TEST(TestGraphOnly, test_parallel_strongly_connected_components_random)
+{
+	// Enough vertices for every step of the parallel search: a giant component, trimmed vertices, and coloring rounds
+	std::mt19937 random(378);
+	const std::size_t n = 1 << 16;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 3 * n / 2; ++i)
+		ed.push_back(std::make_pair(random() % n, random() % n));
+	// A path of two-vertex cycles along the vertex numbers, which one coloring round finishes
+	for(std::size_t v = n; v != n + 40000; v += 2)
+	{
+		ed.push_back(std::make_pair(v, v + 1));
+		ed.push_back(std::make_pair(v + 1, v));
+		ed.push_back(std::make_pair(v + 1, v + 2));
+	}
+	basic_graph<std::uint32_t, sorted_vecS> g(ed.begin(), ed.end());
+	std::vector<std::size_t> expected(num_vertices(g));
+	std::vector<std::size_t> component(num_vertices(g));
+	std::vector<std::size_t> again(num_vertices(g));
+	const std::size_t count = strongly_connected_components(g, expected.begin());
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_strongly_connected_components(g, component.begin(), pool), count);
+	ASSERT_TRUE(same_partition(component, expected));
+	ASSERT_TRUE(reverse_topological(g, component));
+	ThreadPool single(1);
+	parallel_strongly_connected_components(g, again.begin(), single);
+	ASSERT_EQ(again, component);
+	Graph dag = condensation(g, component.begin(), count, pool);
+	ASSERT_EQ(num_vertices(dag), count);
+	ASSERT_FALSE(has_cycle(dag));
+}
+
+TEST(TestGraphOnly, test_parallel_strongly_connected_components_against_order)
+{
+	// A path of two-vertex cycles against the vertex numbers, whose coloring round is abandoned for Tarjan's algorithm
+	const std::size_t n = 40000;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t v = n; v != 0; v -= 2)
+	{
+		ed.push_back(std::make_pair(v, v + 1));
+		ed.push_back(std::make_pair(v + 1, v));
+		ed.push_back(std::make_pair(v, v - 2));
+	}
+	CSRGraph g(ed.begin(), ed.end());
+	std::vector<std::size_t> expected(num_vertices(g));
+	std::vector<std::size_t> component(num_vertices(g));
+	const std::size_t count = strongly_connected_components(g, expected.begin());
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_strongly_connected_components(g, component.begin(), pool), count);
+	ASSERT_TRUE(same_partition(component, expected));
+	ASSERT_TRUE(reverse_topological(g, component));
+}
+
+// --------------------------
+// test_breadth_first_search
+// --------------------------
+
+TYPED_TEST(TestGraphSample, test_breadth_first_search)
+{
+	std::vector<std::size_t> distance(num_vertices(this->g));
+	ASSERT_EQ(breadth_first_search(this->g, this->vdA, distance.begin()), 7);
+	ASSERT_EQ(distance[this->vdA], 0);
+	ASSERT_EQ(distance[this->vdB], 1);
+	ASSERT_EQ(distance[this->vdE], 1);
+	ASSERT_EQ(distance[this->vdD], 2);
+	ASSERT_EQ(distance[this->vdF], 3);
+	ASSERT_EQ(distance[this->vdH], 4);
+	ASSERT_EQ(distance[this->vdG], unreached);
+}
+
+TYPED_TEST(TestGraphSample, test_breadth_first_search_sources)
+{
+	std::vector<std::size_t> distance(num_vertices(this->g));
+	std::vector<typename TestFixture::vertex_descriptor> sources = {this->vdG, this->vdC, this->vdG};
+	ASSERT_EQ(breadth_first_search(this->g, sources.begin(), sources.end(), distance.begin()), 6);
+	ASSERT_EQ(distance[this->vdG], 0);
+	ASSERT_EQ(distance[this->vdC], 0);
+	ASSERT_EQ(distance[this->vdH], 1);
+	ASSERT_EQ(distance[this->vdF], 2);
+	ASSERT_EQ(distance[this->vdA], unreached);
+}
+
+TYPED_TEST(TestGraphSample, test_parallel_breadth_first_search)
+{
+	std::vector<std::size_t> expected(num_vertices(this->g));
+	std::vector<std::size_t> distance(num_vertices(this->g));
+	std::vector<typename TestFixture::vertex_descriptor> sources = {this->vdA, this->vdG};
+	breadth_first_search(this->g, sources.begin(), sources.end(), expected.begin());
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_breadth_first_search(this->g, sources.begin(), sources.end(), distance.begin(), pool), 8);
+	ASSERT_EQ(distance, expected);
+}
+
+TYPED_TEST(TestGraphSample, test_reachable_from)
+{
+	std::vector<typename TestFixture::vertex_descriptor> sources(1, this->vdD);
+	std::vector<typename TestFixture::vertex_descriptor> reached;
+	reachable_from(this->g, sources.begin(), sources.end(), std::back_inserter(reached));
+	ASSERT_EQ(reached.size(), 4);
+	ASSERT_EQ(reached[0], this->vdD);
+	ASSERT_EQ(reached[1], this->vdE);
+	ASSERT_EQ(reached[2], this->vdF);
+	ASSERT_EQ(reached[3], this->vdH);
+	ThreadPool pool(4);
+	std::vector<typename TestFixture::vertex_descriptor> again;
+	reachable_from(this->g, sources.begin(), sources.end(), std::back_inserter(again), pool);
+	ASSERT_EQ(again, reached);
+}
+
+TEST(TestGraphOnly, test_parallel_breadth_first_search_random)
+{
+	// Enough edges for the search to turn bottom-up in the middle levels and top-down again for the last ones
+	std::mt19937 random(378);
+	const std::size_t n = 1 << 16;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 8 * n; ++i)
+		ed.push_back(std::make_pair(random() % n, random() % n));
+	CSRGraph g(ed.begin(), ed.end(), n);
+	std::vector<std::size_t> sources = {0, 1, 2};
+	std::vector<std::size_t> expected(n);
+	std::vector<std::size_t> distance(n);
+	const std::size_t reached = breadth_first_search(g, sources.begin(), sources.end(), expected.begin());
+	ThreadPool pool(4);
+	ASSERT_EQ(parallel_breadth_first_search(g, sources.begin(), sources.end(), distance.begin(), pool), reached);
+	ASSERT_EQ(distance, expected);
+	std::vector<std::size_t> in_offsets;
+	std::vector<std::size_t> in_sources;
+	transpose_adjacency(g, in_offsets, in_sources, pool);
+	ASSERT_EQ(parallel_breadth_first_search(g, sources.begin(), sources.end(), distance.begin(), in_offsets, in_sources, pool), reached);
+	ASSERT_EQ(distance, expected);
+	ThreadPool single(1);
+	ASSERT_EQ(parallel_breadth_first_search(g, sources.begin(), sources.end(), distance.begin(), in_offsets, in_sources, single), reached);
+	ASSERT_EQ(distance, expected);
+}
+
+TEST(TestGraphOnly, test_parallel_breadth_first_search_chain)
+{
+	const std::size_t n = 100000;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t v = 0; v + 1 < n; ++v)
+		ed.push_back(std::make_pair(v, v + 1));
+	basic_graph<std::uint32_t, sorted_vecS> g(ed.begin(), ed.end());
+	std::vector<std::uint32_t> sources(1, 10);
+	std::vector<std::size_t> distance(n);
+	ThreadPool pool(4);
+	std::vector<std::size_t> in_offsets;
+	std::vector<std::uint32_t> in_sources;
+	transpose_adjacency(g, in_offsets, in_sources, pool);
+	ASSERT_EQ(parallel_breadth_first_search(g, sources.begin(), sources.end(), distance.begin(), in_offsets, in_sources, pool), n - 10);
+	ASSERT_EQ(distance[9], unreached);
+	ASSERT_EQ(distance[n - 1], n - 11);
+}
+
+// ---------------------
+// test_common_neighbors
+// ---------------------
+
+TYPED_TEST(TestGraphSample, test_common_neighbors)
+{
+	ASSERT_EQ(common_neighbors(this->vdA, this->vdB, this->g), 1);
+	ASSERT_EQ(common_neighbors(this->vdB, this->vdC, this->g), 1);
+	ASSERT_EQ(common_neighbors(this->vdA, this->vdD, this->g), 1);
+	ASSERT_EQ(common_neighbors(this->vdD, this->vdF, this->g), 0);
+	ASSERT_EQ(common_neighbors(this->vdA, this->vdA, this->g), 3);
+	ASSERT_EQ(common_neighbors(this->vdE, this->vdA, this->g), 0);
+}
+
+// -------------------
+// test_triangle_count
+// -------------------
+
+TYPED_TEST(TestGraphSample, test_triangle_count)
+{
+	ASSERT_EQ(triangle_count(this->g), 2);
+	ThreadPool pool(4);
+	ASSERT_EQ(triangle_count(this->g, pool), 2);
+}
+
+TYPED_TEST(TestGraphSample, test_triangle_count_loops)
+{
+	add_edge(this->vdE, this->vdE, this->g);
+	add_edge(this->vdA, this->vdA, this->g);
+	ASSERT_EQ(triangle_count(this->g), 2);
+	add_edge(this->vdB, this->vdA, this->g);
+	ASSERT_EQ(triangle_count(this->g), 3);
+	add_edge(this->vdC, this->vdB, this->g);
+	ASSERT_EQ(triangle_count(this->g), 5);
+}
+
+// ----------------------
+// test_intersection_size
+// ----------------------
+
+template <typename T>
+void check_intersection_kernels (std::mt19937& random, std::size_t n1, std::size_t n2, T range)
+{
+	std::set<T> s1;
+	std::set<T> s2;
+	while(s1.size() < n1)
+		s1.insert(random() % range);
+	while(s2.size() < n2)
+		s2.insert(random() % range);
+	std::vector<T> a(s1.begin(), s1.end());
+	std::vector<T> b(s2.begin(), s2.end());
+	std::vector<T> common;
+	std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(common));
+	const T* pa = a.data();
+	const T* pb = b.data();
+	ASSERT_EQ(intersect_scalar(pa, pa + a.size(), pb, pb + b.size()), common.size());
+	ASSERT_EQ(intersect_scalar(s1.begin(), s1.end(), s2.begin(), s2.end()), common.size());
+	ASSERT_EQ(intersection_size(a.begin(), a.end(), b.begin(), b.end()), common.size());
+	ASSERT_EQ(intersection_size(s1.begin(), s1.end(), b.begin(), b.end()), common.size());
+	ASSERT_EQ(intersect_arrays(pa, pa + a.size(), pb, pb + b.size(), isa_scalar), common.size());
+	if(intersection_isa() != isa_scalar)
+	{
+		ASSERT_EQ(intersect_arrays(pa, pa + a.size(), pb, pb + b.size(), isa_sse), common.size());
+	}
+	if(intersection_isa() == isa_avx2)
+	{
+		ASSERT_EQ(intersect_arrays(pa, pa + a.size(), pb, pb + b.size(), isa_avx2), common.size());
+	}
+}
+
+TEST(TestGraphOnly, test_intersection_size)
+{
+	std::mt19937 random(378);
+	const std::size_t sizes[] = {0, 1, 3, 4, 7, 8, 9, 31, 100, 1000};
+	for(std::size_t n1 : sizes)
+	{
+		for(std::size_t n2 : sizes)
+		{
+			check_intersection_kernels<std::uint32_t>(random, n1, n2, 2000);
+			check_intersection_kernels<std::size_t>(random, n1, n2, 2000);
+			check_intersection_kernels<std::uint64_t>(random, n1, n2, std::uint64_t(1) << 40);
+		}
+	}
+	check_intersection_kernels<std::uint32_t>(random, 10, 5000, 6000);
+	check_intersection_kernels<std::size_t>(random, 5000, 10, 6000);
+}
+
+TEST(TestGraphOnly, test_triangle_count_random)
+{
+	std::mt19937 random(378);
+	const std::size_t n = 300;
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 6000; ++i)
+		ed.push_back(std::make_pair(random() % n, random() % n));
+	Graph g(ed.begin(), ed.end());
+	CSRGraph c(ed.begin(), ed.end(), n);
+	basic_graph<std::uint32_t, sorted_vecS> s(ed.begin(), ed.end());
+	std::vector<char> matrix(n * n, 0);
+	for(const std::pair<std::size_t, std::size_t>& e : ed)
+		matrix[e.first * n + e.second] = 1;
+	std::size_t expected = 0;
+	for(std::size_t u = 0; u != n; ++u)
+		for(std::size_t v = 0; v != n; ++v)
+			for(std::size_t w = 0; w != n; ++w)
+				expected += (u != v && v != w && u != w && matrix[u * n + v] && matrix[u * n + w] && matrix[v * n + w]);
+	ASSERT_EQ(triangle_count(g), expected);
+	ASSERT_EQ(triangle_count(c), expected);
+	ASSERT_EQ(triangle_count(s), expected);
+	ThreadPool pool(4);
+	ASSERT_EQ(triangle_count(c, pool), expected);
+	ASSERT_EQ(common_neighbors(3, 5, c), common_neighbors(3, 5, g));
+}
+
+// ---------------------
+// test_concurrent_graph
+// ---------------------
+
+TEST(TestGraphOnly, test_concurrent_graph)
+{
+	ConcurrentGraph<> cg;
+	ASSERT_EQ(num_vertices(cg), 0);
+	ASSERT_EQ(add_vertex(cg), 0);
+	ASSERT_EQ(add_edge(3, 1, cg), std::make_pair(std::size_t(3), std::size_t(1)));
+	add_edge(3, 0, cg);
+	add_edge(3, 1, cg);
+	ASSERT_EQ(num_vertices(cg), 4);
+	ASSERT_EQ(num_edges(cg), 3);
+	std::vector<std::size_t> targets;
+	read_adjacent(3, cg, std::back_inserter(targets));
+	ASSERT_EQ(targets, std::vector<std::size_t>({1, 0, 1}));
+	read_adjacent(9, cg, std::back_inserter(targets));
+	ASSERT_EQ(targets.size(), 3);
+
+	ThreadPool pool(2);
+	CSRGraph g = freeze(cg, pool);
+	ASSERT_EQ(num_vertices(g), 4);
+	ASSERT_EQ(num_edges(g), 2);
+	ASSERT_TRUE(edge(3, 0, g).second);
+	ASSERT_TRUE(edge(3, 1, g).second);
+	ASSERT_EQ(num_vertices(cg), 4);
+	ASSERT_EQ(num_edges(cg), 0);
+}
+
+TEST(TestGraphOnly, test_concurrent_graph_threads)
+{
+	// Every thread adds its own share of the edges, and of the vertices, while another thread reads
+	std::mt19937 random(378);
+	const std::size_t n = 100000;
+	const std::size_t threads = 8;
+	std::vector<std::pair<std::uint32_t, std::uint32_t> > ed;
+	for(std::size_t i = 0; i != 4 * n; ++i)
+		ed.push_back(std::make_pair(random() % n, random() % n));
+	ConcurrentGraph<std::uint32_t> cg;
+	std::atomic<bool> writing(true);
+	std::thread reader([&] ()
+	{
+		std::vector<std::uint32_t> targets;
+		while(writing.load())
+		{
+			const std::size_t v = num_vertices(cg);
+			if(v != 0)
+				read_adjacent(static_cast<std::uint32_t>(v - 1), cg, std::back_inserter(targets));
+			targets.clear();
+		}
+	});
+	std::vector<std::thread> writers;
+	std::vector<std::vector<std::uint32_t> > added(threads);
+	for(std::size_t t = 0; t != threads; ++t)
+	{
+		writers.push_back(std::thread([&, t] ()
+		{
+			for(std::size_t i = t; i < ed.size(); i += threads)
+			{
+				add_edge(ed[i].first, ed[i].second, cg);
+				if(i % 1000 == 0)
+					added[t].push_back(add_vertex(cg));
+			}
+		}));
+	}
+	for(std::thread& w : writers)
+		w.join();
+	writing.store(false);
+	reader.join();
+
+	ASSERT_EQ(num_edges(cg), ed.size());
+	std::vector<std::uint32_t> fresh;
+	for(const std::vector<std::uint32_t>& a : added)
+		fresh.insert(fresh.end(), a.begin(), a.end());
+	std::sort(fresh.begin(), fresh.end());
+	ASSERT_TRUE(std::adjacent_find(fresh.begin(), fresh.end()) == fresh.end());
+	const std::size_t vertices = num_vertices(cg);
+	ASSERT_GE(vertices, n);
+	ASSERT_EQ(fresh.back() + 1, vertices);
+
+	ThreadPool pool(4);
+	CSRGraph g = freeze(cg, pool);
+	CSRGraph expected(ed.begin(), ed.end(), vertices);
+	ASSERT_EQ(num_vertices(g), num_vertices(expected));
+	ASSERT_EQ(num_edges(g), num_edges(expected));
+	ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(expected).first));
+}
+
+// ------------
+// test_reorder
+// ------------
+
+template <typename V>
+bool is_permutation_pair (const vertex_permutation<V>& p)
+{
+	if(p.to_new.size() != p.to_old.size())
+		return false;
+	for(std::size_t v = 0; v != p.to_new.size(); ++v)
+	{
+		if(p.to_new[v] >= p.to_old.size() || p.to_old[p.to_new[v]] != v)
+			return false;
+	}
+	return true;
+}
+
+TYPED_TEST(TestGraphSample, test_reorder_breadth_first)
+{
+	vertex_permutation<typename TestFixture::vertex_descriptor> p = reorder(this->g, breadth_first_order);
+	ASSERT_TRUE(is_permutation_pair(p));
+	std::vector<typename TestFixture::vertex_descriptor> expected = {this->vdA, this->vdB, this->vdC, this->vdE, this->vdD, this->vdF, this->vdH, this->vdG};
+	ASSERT_EQ(p.to_old, expected);
+}
+
+TYPED_TEST(TestGraphSample, test_reorder_depth_first)
+{
+	vertex_permutation<typename TestFixture::vertex_descriptor> p = reorder(this->g, depth_first_order);
+	ASSERT_TRUE(is_permutation_pair(p));
+	std::vector<typename TestFixture::vertex_descriptor> expected = {this->vdA, this->vdB, this->vdD, this->vdE, this->vdF, this->vdH, this->vdC, this->vdG};
+	ASSERT_EQ(p.to_old, expected);
+}
+
+TYPED_TEST(TestGraphSample, test_reorder_degree_descending)
+{
+	vertex_permutation<typename TestFixture::vertex_descriptor> p = reorder(this->g, degree_descending);
+	ASSERT_TRUE(is_permutation_pair(p));
+	std::vector<typename TestFixture::vertex_descriptor> expected = {this->vdD, this->vdA, this->vdB, this->vdE, this->vdF, this->vdC, this->vdH, this->vdG};
+	ASSERT_EQ(p.to_old, expected);
+}
+
+TYPED_TEST(TestGraphSample, test_relabel)
+{
+	vertex_permutation<typename TestFixture::vertex_descriptor> p = reorder(this->g, reverse_cuthill_mckee);
+	ASSERT_TRUE(is_permutation_pair(p));
+	typename TestFixture::graph_type h = relabel(this->g, p);
+	ASSERT_EQ(num_vertices(h), num_vertices(this->g));
+	ASSERT_EQ(num_edges(h), num_edges(this->g));
+	std::pair<typename TestFixture::edge_iterator, typename TestFixture::edge_iterator> es = edges(this->g);
+	for(; es.first != es.second; ++es.first)
+		ASSERT_TRUE(edge(p.to_new[source(*es.first, this->g)], p.to_new[target(*es.first, this->g)], h).second);
+	ASSERT_EQ(has_cycle(h), has_cycle(this->g));
+}
+
+TEST(TestGraphOnly, test_reorder_reverse_cuthill_mckee)
+{
+	// A path whose vertices are scattered comes back as a path with neighbouring labels
+	std::mt19937 random(378);
+	const std::size_t n = 1000;
+	std::vector<std::size_t> scatter(n);
+	std::iota(scatter.begin(), scatter.end(), 0);
+	std::shuffle(scatter.begin(), scatter.end(), random);
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t v = 0; v + 1 < n; ++v)
+		ed.push_back(std::make_pair(scatter[v], scatter[v + 1]));
+	CSRGraph g(ed.begin(), ed.end(), n);
+	vertex_permutation<std::size_t> p = reorder(g, reverse_cuthill_mckee);
+	ASSERT_TRUE(is_permutation_pair(p));
+	CSRGraph h = relabel(g, p);
+	std::pair<CSRGraph::edge_iterator, CSRGraph::edge_iterator> es = edges(h);
+	for(; es.first != es.second; ++es.first)
+	{
+		const std::size_t u = source(*es.first, h);
+		const std::size_t v = target(*es.first, h);
+		ASSERT_EQ(std::max(u, v) - std::min(u, v), 1);
+	}
+}
+
+// -------------------
+// test_shortest_paths
+// -------------------
+
+template <typename W>
+struct sample_weight
+{
+	W operator () (std::size_t u, std::size_t v) const
+	{
+		return W((u + 2 * v) % 4 + 1);
+	}
+};
+
+TYPED_TEST(TestGraphSample, test_edge_property_map)
+{
+	edge_property_map<int> weight(this->g, sample_weight<int>());
+	ASSERT_EQ(weight.size(), num_edges(this->g));
+	ASSERT_EQ(edge_value(weight, this->vdA, this->vdB, this->g), 3);
+	ASSERT_EQ(edge_value(weight, this->vdB, this->vdD, this->g), 4);
+	ASSERT_EQ(edge_value(weight, this->vdF, this->vdH, this->g), 4);
+	ASSERT_EQ(edge_value(weight, this->vdG, this->vdH, this->g), 1);
+	ASSERT_EQ(weight.row(this->vdA).second - weight.row(this->vdA).first, 3);
+	ASSERT_TRUE(weight.row(this->vdH).first == weight.row(this->vdH).second);
+}
+
+TYPED_TEST(TestGraphSample, test_edge_property_map_list)
+{
+	typedef typename TestFixture::vertex_descriptor vertex_descriptor;
+	std::vector<std::pair<std::pair<vertex_descriptor, vertex_descriptor>, int> > listed = {
+		std::make_pair(std::make_pair(this->vdD, this->vdF), 7),
+		std::make_pair(std::make_pair(this->vdA, this->vdC), 5),
+		std::make_pair(std::make_pair(this->vdD, this->vdF), 8),
+		std::make_pair(std::make_pair(this->vdH, this->vdA), 9)};
+	edge_property_map<int> weight(this->g, listed.begin(), listed.end(), -1);
+	ASSERT_EQ(weight.size(), num_edges(this->g));
+	ASSERT_EQ(edge_value(weight, this->vdA, this->vdC, this->g), 5);
+	ASSERT_EQ(edge_value(weight, this->vdD, this->vdF, this->g), 7);
+	ASSERT_EQ(edge_value(weight, this->vdA, this->vdB, this->g), -1);
+}
+
+TYPED_TEST(TestGraphSample, test_dijkstra_shortest_paths)
+{
+	typedef typename TestFixture::vertex_descriptor vertex_descriptor;
+	edge_property_map<double> weight(this->g, sample_weight<double>());
+	std::vector<double> distance(num_vertices(this->g));
+	std::vector<vertex_descriptor> predecessor(num_vertices(this->g));
+	dijkstra_shortest_paths(this->g, weight, this->vdA, distance.begin(), predecessor.begin());
+	const double infinity = std::numeric_limits<double>::max();
+	std::vector<double> expected = {0, 3, 1, 2, 1, 4, infinity, 8};
+	ASSERT_EQ(distance, expected);
+	std::vector<vertex_descriptor> before = {this->vdA, this->vdA, this->vdA, this->vdC, this->vdA, this->vdD, this->vdG, this->vdF};
+	ASSERT_EQ(predecessor, before);
+}
+
+TYPED_TEST(TestGraphSample, test_dijkstra_shortest_paths_radix)
+{
+	edge_property_map<unsigned> weight(this->g, sample_weight<unsigned>());
+	std::vector<unsigned> distance(num_vertices(this->g));
+	dijkstra_shortest_paths(this->g, weight, this->vdA, distance.begin());
+	const unsigned infinity = std::numeric_limits<unsigned>::max();
+	std::vector<unsigned> expected = {0, 3, 1, 2, 1, 4, infinity, 8};
+	ASSERT_EQ(distance, expected);
+}
+
+TYPED_TEST(TestGraphSample, test_dijkstra_shortest_paths_negative)
+{
+	edge_property_map<int> weight(this->g, [] (std::size_t u, std::size_t v) -> int
+	{
+		return u == 5 && v == 7 ? -1 : 1;
+	});
+	std::vector<int> distance(num_vertices(this->g));
+	ASSERT_THROW(dijkstra_shortest_paths(this->g, weight, this->vdA, distance.begin()), boost::negative_edge);
+	dijkstra_shortest_paths(this->g, weight, this->vdG, distance.begin());
+	ASSERT_EQ(distance[this->vdH], 1);
+}
+
+TYPED_TEST(TestGraphSample, test_dag_shortest_paths_cycle)
+{
+	typedef typename TestFixture::vertex_descriptor vertex_descriptor;
+	edge_property_map<int> weight(this->g, sample_weight<int>());
+	std::vector<int> distance(num_vertices(this->g));
+	std::vector<vertex_descriptor> predecessor(num_vertices(this->g));
+	ASSERT_THROW(dag_shortest_paths(this->g, weight, this->vdA, distance.begin(), predecessor.begin()), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_dijkstra_shortest_paths_random)
+{
+	// Both heaps and the Bellman-Ford recurrence agree on a random graph
+	std::mt19937 random(378);
+	const std::size_t n = 300;
+	std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+	std::uniform_int_distribution<unsigned> cost(0, 1000);
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 3 * n; ++i)
+		ed.push_back(std::make_pair(pick(random), pick(random)));
+	CSRGraph g(ed.begin(), ed.end(), n);
+	std::vector<unsigned> costs(num_edges(g));
+	for(unsigned& c : costs)
+		c = cost(random);
+	std::size_t k = 0;
+	edge_property_map<unsigned> integral(g, [&] (std::size_t, std::size_t) -> unsigned
+	{
+		return costs[k++];
+	});
+	k = 0;
+	edge_property_map<double> real(g, [&] (std::size_t, std::size_t) -> double
+	{
+		return costs[k++];
+	});
+
+	std::vector<unsigned> radix(n);
+	std::vector<std::size_t> predecessor(n);
+	dijkstra_shortest_paths(g, integral, 0, radix.begin(), predecessor.begin());
+	std::vector<double> dary(n);
+	dijkstra_shortest_paths(g, real, 0, dary.begin());
+
+	const unsigned infinity = std::numeric_limits<unsigned>::max();
+	std::vector<unsigned> expected(n, infinity);
+	expected[0] = 0;
+	for(bool changed = true; changed; )
+	{
+		changed = false;
+		for(std::size_t u = 0; u != n; ++u)
+		{
+			if(expected[u] == infinity)
+				continue;
+			for(std::size_t j = 0; j != std::size_t(adjacent_vertices(u, g).second - adjacent_vertices(u, g).first); ++j)
+			{
+				const std::size_t v = adjacent_vertices(u, g).first[j];
+				const unsigned d = expected[u] + integral.row(u).first[j];
+				if(d < expected[v])
+				{
+					expected[v] = d;
+					changed = true;
+				}
+			}
+		}
+	}
+	ASSERT_EQ(radix, expected);
+	for(std::size_t v = 0; v != n; ++v)
+	{
+		if(expected[v] == infinity)
+		{
+			ASSERT_EQ(dary[v], std::numeric_limits<double>::max());
+			ASSERT_EQ(predecessor[v], v);
+		}
+		else
+		{
+			ASSERT_EQ(dary[v], expected[v]);
+			if(v != 0)
+			{
+				ASSERT_EQ(radix[predecessor[v]] + edge_value(integral, predecessor[v], v, g), radix[v]);
+			}
+		}
+	}
+}
+
+TEST(TestGraphOnly, test_dag_shortest_paths)
+{
+	// Negative weights are allowed on a DAG: 0 -> 1 -> 3 costs 2 - 5, less than 0 -> 3
+	Graph g;
+	for(int i = 0; i != 5; ++i)
+		add_vertex(g);
+	add_edge(0, 1, g);
+	add_edge(0, 2, g);
+	add_edge(0, 3, g);
+	add_edge(1, 3, g);
+	add_edge(2, 3, g);
+	add_edge(3, 4, g);
+	edge_property_map<int> weight(g, [] (std::size_t u, std::size_t v) -> int
+	{
+		return u == 1 && v == 3 ? -5 : int(u + v);
+	});
+	std::vector<int> distance(5);
+	std::vector<Graph::vertex_descriptor> predecessor(5);
+	dag_shortest_paths(g, weight, 1, distance.begin(), predecessor.begin());
+	std::vector<int> expected = {std::numeric_limits<int>::max(), 0, std::numeric_limits<int>::max(), -5, 2};
+	ASSERT_EQ(distance, expected);
+	dag_shortest_paths(g, weight, 0, distance.begin(), predecessor.begin());
+	expected = {0, 1, 2, -4, 3};
+	ASSERT_EQ(distance, expected);
+	std::vector<Graph::vertex_descriptor> before = {0, 0, 0, 1, 3};
+	ASSERT_EQ(predecessor, before);
+}
+
+// ----------------
+// test_graph_trace
+// ----------------
+
+TEST(TestGraphOnly, test_graph_trace)
+{
+	graph_trace trace;
+	Graph g;
+	for(std::size_t v = 0; v + 1 < 4; ++v)
+		add_edge(v, v + 1, g);
+	add_edge(0, 1, g);
+	const graph_counters built = trace.counters();
+	ASSERT_FALSE(has_cycle(g));
+	std::vector<Graph::vertex_descriptor> order;
+	topological_sort(g, std::back_inserter(order));
+	const graph_counters& c = trace.counters();
+#ifdef GRAPH_TRACE
+	ASSERT_EQ(built.edge_lookups, 4);
+	ASSERT_GE(built.allocations, 1);
+	ASSERT_EQ(built.vertices_visited, 0);
+	ASSERT_EQ(c.vertices_visited, 8);
+	ASSERT_EQ(c.edges_scanned, 6);
+	ASSERT_EQ(c.max_depth, 4);
+	ASSERT_EQ(trace.events().size(), 2);
+	ASSERT_STREQ(trace.events()[0].name, "has_cycle");
+	ASSERT_STREQ(trace.events()[1].name, "topological_sort");
+	ASSERT_LE(trace.events()[0].start + trace.events()[0].duration, trace.events()[1].start);
+	ASSERT_EQ(trace.events()[1].depth, 0);
+#else
+	ASSERT_EQ(built.edge_lookups, 0);
+	ASSERT_EQ(c.vertices_visited, 0);
+	ASSERT_EQ(c.edges_scanned, 0);
+	ASSERT_EQ(c.max_depth, 0);
+	ASSERT_TRUE(trace.events().empty());
+#endif
+}
+
+TEST(TestGraphOnly, test_graph_trace_nested)
+{
+	// The inner trace takes the work done while it is open, and the outer trace resumes after it
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	graph_trace outer;
+	{
+		graph_trace inner;
+		has_cycle(g);
+		ASSERT_EQ(outer.counters().vertices_visited, 0);
+#ifdef GRAPH_TRACE
+		ASSERT_EQ(inner.counters().vertices_visited, 3);
+#endif
+	}
+	std::vector<std::size_t> distance(num_vertices(g));
+	breadth_first_search(g, 1, distance.begin());
+#ifdef GRAPH_TRACE
+	ASSERT_EQ(outer.counters().vertices_visited, 2);
+	ASSERT_EQ(outer.counters().edges_scanned, 1);
+	ASSERT_EQ(outer.events().size(), 1);
+	outer.clear();
+	ASSERT_EQ(outer.counters().vertices_visited, 0);
+	ASSERT_TRUE(outer.events().empty());
+#else
+	ASSERT_EQ(outer.counters().vertices_visited, 0);
+#endif
+}
+
+TEST(TestGraphOnly, test_graph_trace_export)
+{
+	graph_trace trace;
+	Graph g;
+	add_edge(0, 1, g);
+	has_cycle(g);
+	std::ostringstream json;
+	trace.write_json(json);
+	std::ostringstream chrome;
+	trace.write_chrome_trace(chrome);
+#ifdef GRAPH_TRACE
+	ASSERT_NE(json.str().find("\"vertices_visited\": 2"), std::string::npos);
+	ASSERT_NE(json.str().find("{\"name\": \"has_cycle\", \"start_us\": "), std::string::npos);
+	ASSERT_NE(chrome.str().find("{\"name\": \"has_cycle\", \"cat\": \"graph\", \"ph\": \"X\""), std::string::npos);
+#else
+	ASSERT_EQ(json.str(), "{\"counters\": {\"vertices_visited\": 0, \"edges_scanned\": 0, \"edge_lookups\": 0, \"allocations\": 0, \"max_depth\": 0}, \"phases\": []}");
+#endif
+	ASSERT_EQ(chrome.str().find("{\"traceEvents\": ["), 0);
+	ASSERT_NE(chrome.str().find("\"ph\": \"C\""), std::string::npos);
+	ASSERT_EQ(chrome.str().substr(chrome.str().size() - 3), "}]}");
+}
+
+// -----------------------
+// test_reachability_index
+// -----------------------
+
+TYPED_TEST(TestGraphSample, test_reachability_index_cycle)
+{
+	ASSERT_THROW(reachability_index<typename TestFixture::vertex_descriptor> index(this->g), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_reachability_index)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(1, 2, g);
+	add_edge(3, 2, g);
+	add_vertex(g);
+	for(std::size_t limit : {reachability_dense_bytes, std::size_t(0)})
+	{
+		reachability_index<std::size_t> index(g, limit);
+		ASSERT_EQ(index.size(), 5);
+		ASSERT_EQ(index.dense(), limit != 0);
+		ASSERT_TRUE(index.reaches(0, 0));
+		ASSERT_TRUE(index.reaches(0, 2));
+		ASSERT_TRUE(index.reaches(3, 2));
+		ASSERT_FALSE(index.reaches(2, 0));
+		ASSERT_FALSE(index.reaches(0, 3));
+		ASSERT_FALSE(index.reaches(4, 0));
+		std::vector<std::size_t> reached;
+		index.descendants(0, std::back_inserter(reached));
+		std::vector<std::size_t> expected = {0, 1, 2};
+		ASSERT_EQ(reached, expected);
+	}
+}
+
+TEST(TestGraphOnly, test_transitive_closure)
+{
+	CSRGraph::vertex_descriptor chain[] = {0, 1, 2, 3};
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i + 1 < 4; ++i)
+		ed.push_back(std::make_pair(chain[i], chain[i + 1]));
+	CSRGraph g(ed.begin(), ed.end(), 4);
+	CSRGraph c = transitive_closure(g);
+	ASSERT_EQ(num_vertices(c), 4);
+	ASSERT_EQ(num_edges(c), 6);
+	ASSERT_TRUE(edge(0, 3, c).second);
+	ASSERT_FALSE(edge(3, 0, c).second);
+	ASSERT_FALSE(edge(2, 2, c).second);
+}
+
+TEST(TestGraphOnly, test_reachability_index_random)
+{
+	// Bitsets and intervals, built serially and in parallel, agree with a search from every vertex
+	std::mt19937 random(378);
+	const std::size_t n = 400;
+	std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+	std::vector<std::size_t> scatter(n);
+	std::iota(scatter.begin(), scatter.end(), 0);
+	std::shuffle(scatter.begin(), scatter.end(), random);
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 2 * n; ++i)
+	{
+		std::size_t u = pick(random);
+		std::size_t v = pick(random);
+		if(u != v)
+			ed.push_back(std::make_pair(scatter[std::min(u, v)], scatter[std::max(u, v)]));
+	}
+	CSRGraph g(ed.begin(), ed.end(), n);
+	ThreadPool pool(4);
+	reachability_index<std::size_t> dense(g);
+	reachability_index<std::size_t> sparse(g, 0);
+	reachability_index<std::size_t> parallel_dense(g, pool);
+	reachability_index<std::size_t> parallel_sparse(g, pool, 0);
+	ASSERT_TRUE(dense.dense());
+	ASSERT_FALSE(sparse.dense());
+	ASSERT_FALSE(parallel_sparse.dense());
+	std::vector<std::size_t> distance(n);
+	for(std::size_t u = 0; u != n; ++u)
+	{
+		breadth_first_search(g, u, distance.begin());
+		for(std::size_t v = 0; v != n; ++v)
+		{
+			const bool expected = distance[v] != unreached;
+			ASSERT_EQ(dense.reaches(u, v), expected);
+			ASSERT_EQ(sparse.reaches(u, v), expected);
+			ASSERT_EQ(parallel_dense.reaches(u, v), expected);
+			ASSERT_EQ(parallel_sparse.reaches(u, v), expected);
+		}
+		std::vector<std::size_t> a;
+		std::vector<std::size_t> b;
+		dense.descendants(u, std::back_inserter(a));
+		parallel_sparse.descendants(u, std::back_inserter(b));
+		ASSERT_EQ(a, b);
+	}
+}
+
+// ------------------
+// test_critical_path
+// ------------------
+
+TYPED_TEST(TestGraphSample, test_critical_path_cycle)
+{
+	std::vector<int> cost(num_vertices(this->g), 1);
+	ASSERT_THROW(critical_path(this->g, cost.begin()), boost::not_a_dag);
+	ThreadPool pool(2);
+	ASSERT_THROW(critical_path(this->g, cost.begin(), pool), boost::not_a_dag);
+}
+
+TEST(TestGraphOnly, test_critical_path)
+{
+	Graph g;
+	add_edge(0, 1, g);
+	add_edge(0, 2, g);
+	add_edge(1, 3, g);
+	add_edge(2, 3, g);
+	add_edge(3, 4, g);
+	add_edge(5, 4, g);
+	std::vector<int> cost = {3, 2, 4, 1, 2, 1};
+	ThreadPool pool(2);
+	for(int parallel = 0; parallel != 2; ++parallel)
+	{
+		dag_schedule<std::size_t, int> s = parallel ? critical_path(g, cost.begin(), pool) : critical_path(g, cost.begin());
+		ASSERT_EQ(s.length, 10);
+		std::vector<int> earliest = {0, 3, 3, 7, 8, 0};
+		std::vector<int> latest = {0, 5, 3, 7, 8, 7};
+		std::vector<int> slack = {0, 2, 0, 0, 0, 7};
+		std::vector<std::size_t> critical = {0, 2, 3, 4};
+		ASSERT_EQ(s.earliest, earliest);
+		ASSERT_EQ(s.latest, latest);
+		ASSERT_EQ(s.slack, slack);
+		ASSERT_EQ(s.critical, critical);
+	}
+	std::vector<std::size_t> path;
+	ASSERT_EQ(dag_longest_path(g, cost.begin(), std::back_inserter(path)), 10);
+	std::vector<std::size_t> expected = {0, 2, 3, 4};
+	ASSERT_EQ(path, expected);
+}
+
+TEST(TestGraphOnly, test_critical_path_empty)
+{
+	Graph g;
+	std::vector<int> cost;
+	dag_schedule<std::size_t, int> s = critical_path(g, cost.begin());
+	ASSERT_EQ(s.length, 0);
+	ASSERT_TRUE(s.critical.empty());
+}
+
+TEST(TestGraphOnly, test_critical_path_random)
+{
+	// The parallel schedule is the serial one, and the critical path is a path of zero slack as long as the schedule
+	std::mt19937 random(378);
+	const std::size_t n = 500;
+	std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+	std::uniform_real_distribution<double> duration(0, 10);
+	std::vector<std::pair<std::size_t, std::size_t> > ed;
+	for(std::size_t i = 0; i != 3 * n; ++i)
+	{
+		std::size_t u = pick(random);
+		std::size_t v = pick(random);
+		if(u != v)
+			ed.push_back(std::make_pair(std::max(u, v), std::min(u, v)));
+	}
+	CSRGraph g(ed.begin(), ed.end(), n);
+	std::vector<double> cost(n);
+	for(double& c : cost)
+		c = duration(random);
+
+	ThreadPool pool(4);
+	dag_schedule<std::size_t, double> s = critical_path(g, cost.begin());
+	dag_schedule<std::size_t, double> p = critical_path(g, cost.begin(), pool);
+	ASSERT_EQ(s.earliest, p.earliest);
+	ASSERT_EQ(s.latest, p.latest);
+	ASSERT_EQ(s.critical, p.critical);
+	ASSERT_EQ(s.length, p.length);
+
+	double length = 0;
+	for(std::size_t i = 0; i != s.critical.size(); ++i)
+	{
+		length += cost[s.critical[i]];
+		ASSERT_NEAR(s.slack[s.critical[i]], 0, 1e-9);
+		if(i != 0)
+		{
+			ASSERT_TRUE(edge(s.critical[i - 1], s.critical[i], g).second);
+		}
+	}
+	ASSERT_NEAR(length, s.length, 1e-9);
+	for(std::size_t v = 0; v != n; ++v)
+	{
+		ASSERT_GE(s.slack[v], -1e-9);
+		ASSERT_LE(s.earliest[v] + cost[v], s.length + 1e-9);
+		std::pair<CSRGraph::adjacency_iterator, CSRGraph::adjacency_iterator> av = adjacent_vertices(v, g);
+		for(; av.first != av.second; ++av.first)
+		{
+			ASSERT_GE(s.earliest[*av.first], s.earliest[v] + cost[v]);
+			ASSERT_LE(s.latest[v] + cost[v], s.latest[*av.first] + 1e-9);
+		}
+	}
+}
@@ -0,0 +1,257 @@
+// ---------------------------
+// projects/graph/ThreadPool.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+// --------
+// includes
+// --------
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <algorithm> // inplace_merge, max, min, sort
+#include <atomic> // atomic
+#include <condition_variable> // condition_variable
+#include <exception> // exception_ptr, current_exception, rethrow_exception
+#include <functional> // function
+#include <mutex> // mutex, unique_lock
+#include <thread> // thread, hardware_concurrency
+#include <vector> // vector
+
+
+// ----------
+// ThreadPool
+// ----------
+
+///
+/// A fixed set of worker threads that execute parallel loops for the graph algorithms
+/// The calling thread takes part in every loop, so a ThreadPool of size 1 runs everything on the caller
+/// A loop must not start another loop on the same ThreadPool
+///
+class ThreadPool
+{
+private:
+	// ----
+	// data
+	// ----
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wake; // signals a new loop or shutdown to the workers
+	std::condition_variable done; // signals the caller that every worker left the current loop
+
+	std::function<void (std::size_t, std::size_t)> job;
+	std::atomic<std::size_t> next; // first index of the next unclaimed chunk
+	std::size_t last;
+	std::size_t grain;
+	std::size_t generation; // number of loops started
+	std::size_t running; // workers still inside the current loop
+	bool stopping;
+	std::exception_ptr failure;
+
+	// ----------
+	// run_chunks
+	// ----------
+
+	///
+	/// Claim and execute chunks of the current loop until none are left
+	/// The first exception thrown by the loop body is kept for the caller, and the remaining chunks are skipped
+	///
+	void run_chunks ()
+	{
+		try
+		{
+			while(true)
+			{
+				std::size_t b = next.fetch_add(grain);
+				if(b >= last)
+					break;
+				job(b, std::min(b + grain, last));
+			}
+		}
+		catch(...)
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			if(!failure)
+				failure = std::current_exception();
+			next = last;
+		}
+	}
+
+	// ----
+	// work
+	// ----
+
+	///
+	/// The body of a worker thread: wait for a loop, help run it, and report back
+	///
+	void work ()
+	{
+		std::size_t seen = 0;
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				while(!stopping && generation == seen)
+					wake.wait(guard);
+				if(stopping)
+					return;
+				seen = generation;
+			}
+
+			run_chunks();
+
+			std::unique_lock<std::mutex> guard(lock);
+			if(--running == 0)
+				done.notify_one();
+		}
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Start the worker threads
+	/// @param n - the number of threads that run a loop, including the calling thread; 0 selects the hardware concurrency
+	///
+	explicit ThreadPool (std::size_t n = 0) : next(0), last(0), grain(1), generation(0), running(0), stopping(false)
+	{
+		if(n == 0)
+			n = std::max(1u, std::thread::hardware_concurrency());
+		for(std::size_t i = 1; i < n; ++i)
+			workers.push_back(std::thread(&ThreadPool::work, this));
+	}
+
+	///
+	/// Stop and join the worker threads
+	///
+	~ThreadPool ()
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(std::thread& t : workers)
+			t.join();
+	}
+
+	ThreadPool (const ThreadPool&) = delete;
+	ThreadPool& operator = (const ThreadPool&) = delete;
+
+	// ----
+	// size
+	// ----
+
+	///
+	/// @return the number of threads that run a loop, including the calling thread
+	///
+	std::size_t size () const
+	{
+		return workers.size() + 1;
+	}
+
+	// ------------
+	// parallel_for
+	// ------------
+
+	///
+	/// Run f over [b, e) split into chunks, and return when every chunk is done
+	/// @tparam F - Function Template, called as f(first, last) for each chunk [first, last)
+	/// @param b - the first index
+	/// @param e - one past the last index
+	/// @param f - the loop body
+	/// @param g - the number of indices per chunk; 0 splits [b, e) into a few chunks per thread
+	/// @throws the first exception thrown by f
+	///
+	template <typename F>
+	void parallel_for (std::size_t b, std::size_t e, F f, std::size_t g = 0)
+	{
+		if(b >= e)
+			return;
+		if(g == 0)
+			g = std::max<std::size_t>(1, (e - b) / (4 * size()));
+		if(workers.empty() || e - b <= g)
+		{
+			for(std::size_t i = b; i < e; i += g)
+				f(i, std::min(i + g, e));
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			job = f;
+			next = b;
+			last = e;
+			grain = g;
+			running = workers.size();
+			failure = nullptr;
+			++generation;
+		}
+		wake.notify_all();
+
+		run_chunks();
+
+		std::unique_lock<std::mutex> guard(lock);
+		while(running != 0)
+			done.wait(guard);
+		job = nullptr;
+		if(failure)
+			std::rethrow_exception(failure);
+	}
+};
+
+// -------------
+// parallel_sort
+// -------------
+
+///
+/// Sort a random access range with every thread of the pool
+/// The range is split into one block per thread, the blocks are sorted in parallel, and then merged pairwise in parallel
+/// @tparam RI - Random Access Iterator Template
+/// @param pool - a thread pool
+/// @param b - the beginning of the range
+/// @param e - the end of the range
+///
+template <typename RI>
+void parallel_sort (ThreadPool& pool, RI b, RI e)
+{
+	std::size_t n = e - b;
+	std::size_t blocks = std::min(pool.size(), std::max<std::size_t>(1, n / 4096));
+	if(blocks < 2)
+	{
+		std::sort(b, e);
+		return;
+	}
+
+	std::vector<std::size_t> bounds(blocks + 1);
+	for(std::size_t i = 0; i <= blocks; ++i)
+		bounds[i] = n * i / blocks;
+
+	pool.parallel_for(0, blocks, [&] (std::size_t first, std::size_t last)
+	{
+		for(std::size_t i = first; i < last; ++i)
+			std::sort(b + bounds[i], b + bounds[i + 1]);
+	}, 1);
+
+	for(std::size_t width = 1; width < blocks; width *= 2)
+	{
+		pool.parallel_for(0, (blocks + 2 * width - 1) / (2 * width), [&] (std::size_t first, std::size_t last)
+		{
+			for(std::size_t i = first; i < last; ++i)
+			{
+				std::size_t lo = 2 * width * i;
+				std::size_t mid = std::min(lo + width, blocks);
+				std::size_t hi = std::min(lo + 2 * width, blocks);
+				if(mid < hi)
+					std::inplace_merge(b + bounds[lo], b + bounds[mid], b + bounds[hi]);
+			}
+		}, 1);
+	}
+}
+
+#endif // ThreadPool_h
@@ -0,0 +1,365 @@
+// ---------------------------------
+// projects/graph/TopologicalOrder.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------------
+
+#ifndef TopologicalOrder_h
+#define TopologicalOrder_h
+
+// --------
+// includes
+// --------
+#include <boost/throw_exception.hpp>
+#include <boost/graph/exception.hpp>
+#include <algorithm> // find, inplace_merge, max, reverse, sort
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <iterator> // back_inserter
+#include <utility> // make_pair, move, pair
+#include <vector> // vector
+
+#include "Graph.h" // Graph, topological_sort
+
+
+// ----------------
+// TopologicalOrder
+// ----------------
+
+///
+/// A directed acyclic graph that keeps a topological order of its vertices as edges are added
+/// An edge that agrees with the order costs nothing more than the insertion. An edge u -> v against the order is handled with the Pearce-Kelly algorithm:
+/// a forward search from v and a backward search from u visit only the vertices whose positions lie between those of v and u,
+/// and those vertices are reassigned the same positions, so the work is proportional to the affected region, not to the graph
+/// An edge that would close a cycle is found by the forward search, and rejected with boost::not_a_dag before the graph changes
+/// The graph must only be changed through this class, which keeps the predecessor lists that the backward search needs
+/// @tparam G - Graph Class Template
+///
+template <typename G = Graph>
+class TopologicalOrder
+{
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef G graph_type;
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::vertices_size_type vertices_size_type;
+	typedef typename G::edge_descriptor edge_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+private:
+	// ----
+	// data
+	// ----
+	G dag;
+	std::vector<vertices_size_type> positions; // Position of each vertex in the order
+	std::vector<vertex_descriptor> sequence; // Vertex at each position of the order, sources first
+	std::vector<std::vector<vertex_descriptor> > predecessors;
+	std::vector<char> visited; // Marks of the current searches, cleared after each insertion
+	std::vector<vertex_descriptor> forward; // Vertices reached from the target of the new edge
+	std::vector<vertex_descriptor> backward; // Vertices that reach the source of the new edge
+	std::vector<vertex_descriptor> stack;
+
+	// ----
+	// grow
+	// ----
+
+	///
+	/// Add vertices at the end of the order until every vertex of the graph has a position
+	///
+	void grow ()
+	{
+		const vertices_size_type n = num_vertices(dag);
+		for(vertices_size_type v = positions.size(); v < n; ++v)
+		{
+			positions.push_back(v);
+			sequence.push_back(static_cast<vertex_descriptor>(v));
+		}
+		predecessors.resize(n);
+		visited.resize(n, 0);
+	}
+
+	// --------------
+	// search_forward
+	// --------------
+
+	///
+	/// Collect into forward the vertices reachable from v whose positions are less than upper
+	/// @param v - the target of the new edge
+	/// @param upper - the position of the source of the new edge
+	/// @return false if the search reaches the vertex at position upper, which means the new edge closes a cycle
+	///
+	bool search_forward (vertex_descriptor v, vertices_size_type upper)
+	{
+		stack.assign(1, v);
+		visited[v] = 1;
+		forward.push_back(v);
+		while(!stack.empty())
+		{
+			const vertex_descriptor u = stack.back();
+			stack.pop_back();
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(u, dag);
+			for(; av.first != av.second; ++av.first)
+			{
+				const vertex_descriptor w = *av.first;
+				if(positions[w] == upper)
+					return false;
+				if(!visited[w] && positions[w] < upper)
+				{
+					visited[w] = 1;
+					forward.push_back(w);
+					stack.push_back(w);
+				}
+			}
+		}
+		return true;
+	}
+
+	// ---------------
+	// search_backward
+	// ---------------
+
+	///
+	/// Collect into backward the vertices that reach u and whose positions are greater than lower
+	/// @param u - the source of the new edge
+	/// @param lower - the position of the target of the new edge
+	///
+	void search_backward (vertex_descriptor u, vertices_size_type lower)
+	{
+		stack.assign(1, u);
+		visited[u] = 1;
+		backward.push_back(u);
+		while(!stack.empty())
+		{
+			const vertex_descriptor v = stack.back();
+			stack.pop_back();
+			for(vertex_descriptor w : predecessors[v])
+			{
+				if(!visited[w] && positions[w] > lower)
+				{
+					visited[w] = 1;
+					backward.push_back(w);
+					stack.push_back(w);
+				}
+			}
+		}
+	}
+
+	// -------
+	// reorder
+	// -------
+
+	///
+	/// Give the positions held by the vertices of both searches first to the backward vertices, then to the forward vertices, each in their old relative order
+	///
+	void reorder ()
+	{
+		const std::vector<vertices_size_type>& p = positions;
+		auto before = [&p] (vertex_descriptor a, vertex_descriptor b) {return p[a] < p[b];};
+		std::sort(forward.begin(), forward.end(), before);
+		std::sort(backward.begin(), backward.end(), before);
+
+		std::vector<vertices_size_type> slots;
+		slots.reserve(forward.size() + backward.size());
+		for(vertex_descriptor v : backward)
+			slots.push_back(positions[v]);
+		for(vertex_descriptor v : forward)
+			slots.push_back(positions[v]);
+		std::inplace_merge(slots.begin(), slots.begin() + backward.size(), slots.end());
+
+		std::size_t i = 0;
+		for(vertex_descriptor v : backward)
+			place(v, slots[i++]);
+		for(vertex_descriptor v : forward)
+			place(v, slots[i++]);
+	}
+
+	// -----
+	// place
+	// -----
+
+	///
+	/// @param v - a vertex descriptor
+	/// @param i - the new position of v
+	///
+	void place (vertex_descriptor v, vertices_size_type i)
+	{
+		positions[v] = i;
+		sequence[i] = v;
+	}
+
+	// -----
+	// reset
+	// -----
+
+	///
+	/// Clear the marks and the results of the last searches, in time proportional to the vertices they visited
+	///
+	void reset ()
+	{
+		for(vertex_descriptor v : forward)
+			visited[v] = 0;
+		for(vertex_descriptor v : backward)
+			visited[v] = 0;
+		forward.clear();
+		backward.clear();
+	}
+
+public:
+	// ------------
+	// constructors
+	// ------------
+
+	///
+	/// Build the order of an acyclic graph with one topological_sort
+	/// @param graph - a graph, copied or moved into the structure
+	/// @throws boost::not_a_dag if the graph has a cycle
+	///
+	explicit TopologicalOrder (G graph = G()) : dag(std::move(graph))
+	{
+		const vertices_size_type n = num_vertices(dag);
+		sequence.reserve(n);
+		::topological_sort(dag, std::back_inserter(sequence));
+		std::reverse(sequence.begin(), sequence.end());
+		positions.resize(n);
+		for(vertices_size_type i = 0; i != n; ++i)
+			positions[sequence[i]] = i;
+
+		predecessors.resize(n);
+		visited.resize(n, 0);
+		std::pair<typename G::vertex_iterator, typename G::vertex_iterator> v = vertices(dag);
+		for(; v.first != v.second; ++v.first)
+		{
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(*v.first, dag);
+			for(; av.first != av.second; ++av.first)
+				predecessors[*av.first].push_back(*v.first);
+		}
+	}
+
+	// Default copy, move, destructor, and copy assignment
+
+	// --------
+	// add_edge
+	// --------
+
+	///
+    /// Add an edge to the graph, and update the order in the region between its endpoints
+    /// New vertices are added at the end of the order
+    /// @param u - a vertex descriptor for the source vertex
+    /// @param v - a vertex descriptor for the target vertex
+    /// @param order - a topological order
+    /// @return a std::pair<edge_descriptor, bool> - The bool value is true if the edge was added, and false if it was already present
+    /// @throws boost::not_a_dag, leaving the graph and the order unchanged, if the edge would close a cycle
+    ///
+	friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor u, vertex_descriptor v, TopologicalOrder& order)
+	{
+		if(u == v)
+			boost::throw_exception(boost::not_a_dag());
+		if(std::max(u, v) < order.positions.size())
+		{
+			std::pair<edge_descriptor, bool> present = edge(u, v, order.dag);
+			if(present.second)
+				return std::make_pair(present.first, false);
+		}
+		while(std::max(u, v) >= num_vertices(order.dag))
+			add_vertex(order.dag);
+		order.grow();
+
+		const vertices_size_type lower = order.positions[v];
+		const vertices_size_type upper = order.positions[u];
+		if(lower < upper)
+		{
+			const bool acyclic = order.search_forward(v, upper);
+			if(acyclic)
+			{
+				order.search_backward(u, lower);
+				order.reorder();
+			}
+			order.reset();
+			if(!acyclic)
+				boost::throw_exception(boost::not_a_dag());
+		}
+
+		std::pair<edge_descriptor, bool> added = add_edge(u, v, order.dag);
+		order.predecessors[v].push_back(u);
+		assert(order.positions[u] < order.positions[v]);
+		return added;
+	}
+
+	// -----------
+	// remove_edge
+	// -----------
+
+	///
+    /// Remove an edge from the graph, if it is present, which leaves the order valid
+    /// @param u - a vertex descriptor for the source vertex
+    /// @param v - a vertex descriptor for the target vertex
+    /// @param order - a topological order
+    ///
+	friend void remove_edge (vertex_descriptor u, vertex_descriptor v, TopologicalOrder& order)
+	{
+		if(std::max(u, v) >= order.positions.size() || !edge(u, v, order.dag).second)
+			return;
+		remove_edge(u, v, order.dag);
+		std::vector<vertex_descriptor>& p = order.predecessors[v];
+		*std::find(p.begin(), p.end(), u) = p.back();
+		p.pop_back();
+	}
+
+	// ----------
+	// add_vertex
+	// ----------
+
+	///
+    /// Add a vertex to the graph, at the end of the order
+    /// @param order - a topological order
+    /// @return a vertex_descriptor representing the new vertex
+    ///
+	friend vertex_descriptor add_vertex (TopologicalOrder& order)
+	{
+		const vertex_descriptor v = add_vertex(order.dag);
+		order.grow();
+		return v;
+	}
+
+	// -----
+	// graph
+	// -----
+
+	///
+	/// @return the graph, for reading
+	///
+	const G& graph () const
+	{
+		return dag;
+	}
+
+	// -----
+	// order
+	// -----
+
+	///
+	/// @return the vertices in topological order, sources first, which is the reverse of the output of topological_sort
+	///
+	const std::vector<vertex_descriptor>& order () const
+	{
+		return sequence;
+	}
+
+	// --------
+	// position
+	// --------
+
+	///
+	/// @param v - a vertex descriptor
+	/// @return the position of v in the order
+	///
+	vertices_size_type position (vertex_descriptor v) const
+	{
+		return positions[v];
+	}
+};
+
+#endif // TopologicalOrder_h
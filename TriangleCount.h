@@ -0,0 +1,512 @@
+// ------------------------------
+// projects/graph/TriangleCount.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef TriangleCount_h
+#define TriangleCount_h
+
+// --------
+// includes
+// --------
+#include <algorithm> // lower_bound, max
+#include <atomic> // atomic
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <iterator> // iterator_traits, random_access_iterator_tag
+#include <memory> // addressof
+#include <type_traits> // integral_constant, is_integral, is_lvalue_reference, is_same, remove_cv
+#include <utility> // pair
+#include <vector> // vector
+
+#include "Graph.h" // Graph
+#include "ThreadPool.h" // ThreadPool
+
+// The vector kernels are compiled for their own instruction sets with target attributes, and chosen when the processor has them
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRIANGLE_COUNT_X86 1
+#include <immintrin.h>
+#endif
+
+
+// ---------
+// constants
+// ---------
+
+const std::size_t intersect_skew = 32; // an intersection binary searches the larger set for each value of the smaller one when it is intersect_skew times larger
+
+///
+/// The instruction sets of the intersection kernels
+///
+enum intersect_isa
+{
+	isa_scalar,
+	isa_sse,
+	isa_avx2
+};
+
+// ----------------
+// intersection_isa
+// ----------------
+
+///
+/// Find the best instruction set for the intersection kernels, once per program
+/// @return isa_avx2, isa_sse with SSE 4.2 and POPCNT, or isa_scalar
+///
+inline intersect_isa intersection_isa ()
+{
+#ifdef TRIANGLE_COUNT_X86
+	static const intersect_isa isa = [] () -> intersect_isa
+	{
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+			return isa_avx2;
+		if(__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+			return isa_sse;
+		return isa_scalar;
+	}();
+	return isa;
+#else
+	return isa_scalar;
+#endif
+}
+
+// ----------------
+// intersect_scalar
+// ----------------
+
+///
+/// Count the values common to two ascending sequences of unique values by a merge
+/// The merge advances by the results of the comparisons instead of branching on them, so it does not depend on the branch predictor
+/// @tparam I1 - Input Iterator Template
+/// @tparam I2 - Input Iterator Template
+/// @param b1 - the beginning of the first sequence
+/// @param e1 - the end of the first sequence
+/// @param b2 - the beginning of the second sequence
+/// @param e2 - the end of the second sequence
+/// @return the number of values in both sequences
+///
+template <typename I1, typename I2>
+std::size_t intersect_scalar (I1 b1, I1 e1, I2 b2, I2 e2)
+{
+	std::size_t count = 0;
+	while(b1 != e1 && b2 != e2)
+	{
+		const typename std::iterator_traits<I1>::value_type x = *b1;
+		const typename std::iterator_traits<I2>::value_type y = *b2;
+		count += (x == y);
+		if(!(y < x))
+			++b1;
+		if(!(x < y))
+			++b2;
+	}
+	return count;
+}
+
+///
+/// Count the values common to two ascending arrays of unique values by a merge, with no branches in the loop body
+/// @tparam T - the value type
+/// @param a - the beginning of the first array
+/// @param ae - the end of the first array
+/// @param b - the beginning of the second array
+/// @param be - the end of the second array
+/// @return the number of values in both arrays
+///
+template <typename T>
+std::size_t intersect_scalar (const T* a, const T* ae, const T* b, const T* be)
+{
+	std::size_t count = 0;
+	while(a != ae && b != be)
+	{
+		const T x = *a;
+		const T y = *b;
+		count += (x == y);
+		a += (x <= y);
+		b += (y <= x);
+	}
+	return count;
+}
+
+// ----------------
+// intersect_gallop
+// ----------------
+
+///
+/// Count the values common to a small and a much larger ascending array of unique values, with a binary search of the rest of the larger array for each value of the smaller one
+/// @tparam T - the value type
+/// @param a - the beginning of the smaller array
+/// @param ae - the end of the smaller array
+/// @param b - the beginning of the larger array
+/// @param be - the end of the larger array
+/// @return the number of values in both arrays
+///
+template <typename T>
+std::size_t intersect_gallop (const T* a, const T* ae, const T* b, const T* be)
+{
+	std::size_t count = 0;
+	for(; a != ae; ++a)
+	{
+		b = std::lower_bound(b, be, *a);
+		if(b == be)
+			break;
+		if(*b == *a)
+		{
+			++count;
+			++b;
+		}
+	}
+	return count;
+}
+
+#ifdef TRIANGLE_COUNT_X86
+
+// -------------
+// intersect_sse
+// -------------
+
+///
+/// Count the values common to two ascending arrays of unique 32-bit values, four by four
+/// Each step compares a block of four values of a with every rotation of a block of four values of b, then moves past the block with the smaller last value, or both
+/// A value of a matches at most one value of b, so the bits of the compare masks count the common values without repeats; the arrays finish with a scalar merge
+/// @tparam T - a 32-bit value type
+///
+template <typename T>
+__attribute__((target("sse4.2,popcnt")))
+std::size_t intersect_sse_32 (const T* a, const T* ae, const T* b, const T* be)
+{
+	static_assert(sizeof(T) == 4, "intersect_sse_32 needs 32-bit values");
+	std::size_t count = 0;
+	const T* const as = a + ((ae - a) & ~std::ptrdiff_t(3));
+	const T* const bs = b + ((be - b) & ~std::ptrdiff_t(3));
+	while(a != as && b != bs)
+	{
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+		__m128i m = _mm_cmpeq_epi32(va, vb);
+		m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+		m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+		count += _mm_popcnt_u32(_mm_movemask_ps(_mm_castsi128_ps(m)));
+		const T amax = a[3];
+		const T bmax = b[3];
+		a += 4 * (amax <= bmax);
+		b += 4 * (bmax <= amax);
+	}
+	return count + intersect_scalar(a, ae, b, be);
+}
+
+///
+/// Count the values common to two ascending arrays of unique 64-bit values, two by two, as intersect_sse_32 does
+/// @tparam T - a 64-bit value type
+///
+template <typename T>
+__attribute__((target("sse4.2,popcnt")))
+std::size_t intersect_sse_64 (const T* a, const T* ae, const T* b, const T* be)
+{
+	static_assert(sizeof(T) == 8, "intersect_sse_64 needs 64-bit values");
+	std::size_t count = 0;
+	const T* const as = a + ((ae - a) & ~std::ptrdiff_t(1));
+	const T* const bs = b + ((be - b) & ~std::ptrdiff_t(1));
+	while(a != as && b != bs)
+	{
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+		__m128i m = _mm_cmpeq_epi64(va, vb);
+		m = _mm_or_si128(m, _mm_cmpeq_epi64(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		count += _mm_popcnt_u32(_mm_movemask_pd(_mm_castsi128_pd(m)));
+		const T amax = a[1];
+		const T bmax = b[1];
+		a += 2 * (amax <= bmax);
+		b += 2 * (bmax <= amax);
+	}
+	return count + intersect_scalar(a, ae, b, be);
+}
+
+// --------------
+// intersect_avx2
+// --------------
+
+///
+/// Count the values common to two ascending arrays of unique 32-bit values, eight by eight, as intersect_sse_32 does
+/// @tparam T - a 32-bit value type
+///
+template <typename T>
+__attribute__((target("avx2,popcnt")))
+std::size_t intersect_avx2_32 (const T* a, const T* ae, const T* b, const T* be)
+{
+	static_assert(sizeof(T) == 4, "intersect_avx2_32 needs 32-bit values");
+	std::size_t count = 0;
+	const T* const as = a + ((ae - a) & ~std::ptrdiff_t(7));
+	const T* const bs = b + ((be - b) & ~std::ptrdiff_t(7));
+	const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	while(a != as && b != bs)
+	{
+		const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+		__m256i m = _mm256_cmpeq_epi32(va, vb);
+		for(int r = 1; r != 8; ++r)
+		{
+			vb = _mm256_permutevar8x32_epi32(vb, rotate);
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+		}
+		count += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+		const T amax = a[7];
+		const T bmax = b[7];
+		a += 8 * (amax <= bmax);
+		b += 8 * (bmax <= amax);
+	}
+	return count + intersect_scalar(a, ae, b, be);
+}
+
+///
+/// Count the values common to two ascending arrays of unique 64-bit values, four by four, as intersect_sse_32 does
+/// @tparam T - a 64-bit value type
+///
+template <typename T>
+__attribute__((target("avx2,popcnt")))
+std::size_t intersect_avx2_64 (const T* a, const T* ae, const T* b, const T* be)
+{
+	static_assert(sizeof(T) == 8, "intersect_avx2_64 needs 64-bit values");
+	std::size_t count = 0;
+	const T* const as = a + ((ae - a) & ~std::ptrdiff_t(3));
+	const T* const bs = b + ((be - b) & ~std::ptrdiff_t(3));
+	while(a != as && b != bs)
+	{
+		const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+		const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+		__m256i m = _mm256_cmpeq_epi64(va, vb);
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+		count += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(m)));
+		const T amax = a[3];
+		const T bmax = b[3];
+		a += 4 * (amax <= bmax);
+		b += 4 * (bmax <= amax);
+	}
+	return count + intersect_scalar(a, ae, b, be);
+}
+
+#endif // TRIANGLE_COUNT_X86
+
+// -----------------
+// intersection_size
+// -----------------
+
+#ifdef TRIANGLE_COUNT_X86
+
+///
+/// A helper function for intersect_arrays, for 32-bit values
+///
+template <typename T>
+std::size_t intersect_vector (const T* a, const T* ae, const T* b, const T* be, intersect_isa isa, std::integral_constant<std::size_t, 4>)
+{
+	return isa == isa_avx2 ? intersect_avx2_32(a, ae, b, be) : intersect_sse_32(a, ae, b, be);
+}
+
+///
+/// A helper function for intersect_arrays, for 64-bit values
+///
+template <typename T>
+std::size_t intersect_vector (const T* a, const T* ae, const T* b, const T* be, intersect_isa isa, std::integral_constant<std::size_t, 8>)
+{
+	return isa == isa_avx2 ? intersect_avx2_64(a, ae, b, be) : intersect_sse_64(a, ae, b, be);
+}
+
+#endif // TRIANGLE_COUNT_X86
+
+///
+/// A helper function for intersection_size, which chooses the kernel for two arrays of the same integer type
+/// A much larger array is binary searched; otherwise the widest kernel of the processor for 32-bit or 64-bit values runs
+/// @tparam T - the value type
+/// @param isa - the instruction set of the kernel
+///
+template <typename T>
+std::size_t intersect_arrays (const T* a, const T* ae, const T* b, const T* be, intersect_isa isa)
+{
+	const std::size_t na = ae - a;
+	const std::size_t nb = be - b;
+	if(na == 0 || nb == 0)
+		return 0;
+	if(nb / intersect_skew > na)
+		return intersect_gallop(a, ae, b, be);
+	if(na / intersect_skew > nb)
+		return intersect_gallop(b, be, a, ae);
+#ifdef TRIANGLE_COUNT_X86
+	if(isa != isa_scalar)
+		return intersect_vector(a, ae, b, be, isa, std::integral_constant<std::size_t, sizeof(T)>());
+#endif
+	return intersect_scalar(a, ae, b, be);
+}
+
+///
+/// A helper for intersection_size
+/// True for random access iterators over the lvalues of a 32-bit or 64-bit integer type, which the graphs here only have over contiguous arrays
+/// @tparam I - an iterator type
+///
+template <typename I>
+struct contiguous_integers
+{
+	typedef std::iterator_traits<I> traits;
+	typedef typename std::remove_cv<typename traits::value_type>::type value_type;
+	static const bool value =
+		std::is_same<typename traits::iterator_category, std::random_access_iterator_tag>::value &&
+		std::is_lvalue_reference<typename traits::reference>::value &&
+		std::is_integral<value_type>::value && (sizeof(value_type) == 4 || sizeof(value_type) == 8);
+};
+
+///
+/// A helper function for intersection_size, for sequences that are not arrays of one integer type
+///
+template <typename I1, typename I2>
+std::size_t intersection_size (I1 b1, I1 e1, I2 b2, I2 e2, std::false_type)
+{
+	return intersect_scalar(b1, e1, b2, e2);
+}
+
+///
+/// A helper function for intersection_size, for two arrays of one integer type
+///
+template <typename I1, typename I2>
+std::size_t intersection_size (I1 b1, I1 e1, I2 b2, I2 e2, std::true_type)
+{
+	if(b1 == e1 || b2 == e2)
+		return 0;
+	const typename contiguous_integers<I1>::value_type* a = std::addressof(*b1);
+	const typename contiguous_integers<I2>::value_type* b = std::addressof(*b2);
+	return intersect_arrays(a, a + (e1 - b1), b, b + (e2 - b2), intersection_isa());
+}
+
+///
+/// Count the values common to two ascending sequences of unique values
+/// Two arrays of the same 32-bit or 64-bit integer type, such as the adjacent vertices of a CSRGraph or a sorted_vecS graph, are intersected with SSE 4.2 or AVX2 kernels when the processor has them
+/// Other sequences, such as the adjacent vertices of a std::set graph, are merged one value at a time
+/// @tparam I1 - Input Iterator Template
+/// @tparam I2 - Input Iterator Template
+/// @param b1 - the beginning of the first sequence
+/// @param e1 - the end of the first sequence
+/// @param b2 - the beginning of the second sequence
+/// @param e2 - the end of the second sequence
+/// @return the number of values in both sequences
+///
+template <typename I1, typename I2>
+std::size_t intersection_size (I1 b1, I1 e1, I2 b2, I2 e2)
+{
+	return intersection_size(b1, e1, b2, e2, std::integral_constant<bool,
+		contiguous_integers<I1>::value && contiguous_integers<I2>::value &&
+		std::is_same<typename contiguous_integers<I1>::value_type, typename contiguous_integers<I2>::value_type>::value>());
+}
+
+// ----------------
+// common_neighbors
+// ----------------
+
+///
+/// Count the vertices that both of two vertices have an edge to
+/// The adjacent vertices of every graph here are in ascending order, which the intersection needs
+/// @tparam G - Graph Class Template
+/// @param u - a vertex
+/// @param v - a vertex
+/// @param graph - a graph
+/// @return the number of vertices w with edges (u, w) and (v, w)
+///
+template <typename G>
+std::size_t common_neighbors (typename G::vertex_descriptor u, typename G::vertex_descriptor v, const G& graph)
+{
+	typedef typename G::adjacency_iterator adjacency_iterator;
+	std::pair<adjacency_iterator, adjacency_iterator> au = adjacent_vertices(u, graph);
+	std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+	return intersection_size(au.first, au.second, av.first, av.second);
+}
+
+// ---------------
+// count_triangles
+// ---------------
+
+///
+/// A helper function for the triangle_count functions
+/// Count the triangles whose first edge leaves one of the vertices [b, e), one intersection per edge
+/// The self-loops only matter where the intersection finds u or v itself as the third vertex, and those are taken back out
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param loop - loop[v] is 1 if the graph has the edge (v, v)
+/// @param b - the index of the first vertex
+/// @param e - one past the index of the last vertex
+/// @return the number of triangles
+///
+template <typename G>
+std::size_t count_triangles (const G& graph, const std::vector<char>& loop, std::size_t b, std::size_t e)
+{
+	typedef typename G::vertex_descriptor vertex_descriptor;
+	typedef typename G::adjacency_iterator adjacency_iterator;
+
+	std::size_t count = 0;
+	for(std::size_t i = b; i < e; ++i)
+	{
+		const vertex_descriptor u = vertex(i, graph);
+		std::pair<adjacency_iterator, adjacency_iterator> au = adjacent_vertices(u, graph);
+		for(adjacency_iterator p = au.first; p != au.second; ++p)
+		{
+			const vertex_descriptor v = *p;
+			if(v == u)
+				continue;
+			std::pair<adjacency_iterator, adjacency_iterator> av = adjacent_vertices(v, graph);
+			count += intersection_size(au.first, au.second, av.first, av.second);
+			count -= loop[v];
+			if(loop[u] && edge(v, u, graph).second)
+				--count;
+		}
+	}
+	return count;
+}
+
+// --------------
+// triangle_count
+// --------------
+
+///
+/// Count the triangles of a directed graph: the triples of distinct vertices u, v, w with edges (u, v), (u, w), and (v, w)
+/// Each triangle is one intersection of the adjacent vertices of u and v, for the edge (u, v), so the count takes O(E * d) time
+/// A graph that stores each undirected edge in both directions has six triangles for each undirected triangle
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @return the number of triangles
+///
+template <typename G>
+std::size_t triangle_count (const G& graph)
+{
+	const std::size_t n = num_vertices(graph);
+	std::vector<char> loop(n);
+	for(std::size_t i = 0; i != n; ++i)
+		loop[i] = edge(vertex(i, graph), vertex(i, graph), graph).second;
+	return count_triangles(graph, loop, 0, n);
+}
+
+///
+/// Count the triangles of a directed graph with every thread of the pool, as triangle_count does
+/// Each thread takes chunks of the vertices as the first vertex of a triangle
+/// @tparam G - Graph Class Template
+/// @param graph - a graph
+/// @param pool - the threads that count
+/// @return the number of triangles
+///
+template <typename G>
+std::size_t triangle_count (const G& graph, ThreadPool& pool)
+{
+	const std::size_t n = num_vertices(graph);
+	std::vector<char> loop(n);
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		for(std::size_t i = b; i < e; ++i)
+			loop[i] = edge(vertex(i, graph), vertex(i, graph), graph).second;
+	});
+	std::atomic<std::size_t> count(0);
+	pool.parallel_for(0, n, [&] (std::size_t b, std::size_t e)
+	{
+		count.fetch_add(count_triangles(graph, loop, b, e), std::memory_order_relaxed);
+	}, std::max<std::size_t>(1, n / (16 * pool.size())));
+	return count.load();
+}
+
+#endif // TriangleCount_h
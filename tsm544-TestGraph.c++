@@ -19,6 +19,14 @@
 #include <set>     // set
 #include <queue>   // priority_queue
 #include <map>     // map
+#include <thread>  // thread
+#include <condition_variable> // condition_variable
+#include <mutex>   // mutex
+#include <atomic>  // atomic
+#include <functional> // function
+#include <unordered_map> // unordered_map
+#include <chrono>  // steady_clock
+#include <boost/iterator/counting_iterator.hpp> // counting_iterator
 
 #define private public
 #define protected public